@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utility.hpp"
+#include "wordle.hpp"
+
+/*
+Absurdle: the answer is chosen adversarially. After each guess, the remaining candidates are split into buckets
+by the pattern they would produce, and only the largest bucket is kept. The game is won once the only
+remaining candidate is guessed.
+*/
+
+namespace detail
+{
+	constexpr size_t absurdle_beam_width = 8; // how many guesses to search below each position
+	constexpr size_t absurdle_max_depth = 8;
+}
+
+/*
+The candidates grouped by the pattern they produce for one guess. Bucket p is words[offsets[p], offsets[p + 1]),
+and each bucket keeps the candidates in their original order.
+*/
+template<size_t length>
+struct Partition
+{
+	std::vector<word_t<length>> words;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> codes; // scratch: the pattern of each candidate
+};
+
+/*
+A histogram-and-scatter pass: compute every candidate's pattern once, count the bucket sizes, turn the counts
+into bucket offsets with a prefix sum, then scatter each candidate directly into its bucket.
+*/
+template<size_t length>
+void partition_by_pattern(const std::vector<word_t<length>>& candidates, const word_t<length>& guess, Partition<length>& partition)
+{
+	constexpr size_t patterns = detail::pattern_count(length);
+
+	partition.codes.resize(candidates.size());
+	partition.offsets.assign(patterns + 1, 0);
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		partition.codes[i] = get_pattern(guess, candidates[i]);
+		++partition.offsets[partition.codes[i] + 1];
+	}
+
+	for (size_t p = 0; p < patterns; ++p)
+		partition.offsets[p + 1] += partition.offsets[p];
+
+	partition.words.resize(candidates.size());
+	std::vector<uint32_t> cursor(partition.offsets.begin(), partition.offsets.end() - 1);
+	for (size_t i = 0; i < candidates.size(); ++i)
+		partition.words[cursor[partition.codes[i]]++] = candidates[i];
+}
+
+template<size_t length>
+class Absurdle_solver
+{
+public:
+	explicit Absurdle_solver(const std::vector<word_t<length>>& set_guesses, const size_t set_beam_width = detail::absurdle_beam_width) :
+		guesses{ set_guesses },
+		beam_width{ set_beam_width },
+		histogram(detail::pattern_count(length), 0) {}
+
+	/*
+	Return the guess with the smallest worst-case depth, and that depth: the number of guesses needed to win,
+	counting this one. Only the beam_width most promising guesses are searched below each position.
+	*/
+	std::pair<word_t<length>, size_t> best_guess(const std::vector<word_t<length>>& candidates, const size_t max_depth = detail::absurdle_max_depth)
+	{
+		if (candidates.size() == 1) return { candidates[0], 1 };
+
+		size_t best_index = 0;
+		const size_t depth = search(candidates, max_depth, &best_index);
+		return { guesses[best_index], depth };
+	}
+
+	// Which bucket Absurdle keeps after this guess.
+	uint32_t kept_pattern(const std::vector<word_t<length>>& candidates, const word_t<length>& guess)
+	{
+		return rate(candidates, guess).pattern;
+	}
+
+	size_t nodes_searched() const { return nodes; }
+
+private:
+	struct Move
+	{
+		size_t guess = 0;
+		uint32_t pattern = 0; // the bucket Absurdle would keep
+		uint32_t kept = 0; // its size
+	};
+
+	struct Table_entry
+	{
+		size_t depth = 0;
+		bool exact = false; // if false, depth is only a lower bound
+	};
+
+	// FNV-1a over the letters. The table compares the candidate lists themselves, so a collision only costs time.
+	struct Candidates_hash
+	{
+		size_t operator()(const std::vector<word_t<length>>& candidates) const
+		{
+			uint64_t h = 14695981039346656037ull;
+			for (const auto& word : candidates)
+			{
+				for (size_t i = 0; i < length; ++i)
+				{
+					h ^= uint8_t(word[i]);
+					h *= 1099511628211ull;
+				}
+			}
+			return size_t(h);
+		}
+	};
+
+	static constexpr uint32_t win = uint32_t(detail::pattern_count(length) - 1);
+
+	// The largest bucket wins. On a tie, Absurdle avoids the winning bucket, then prefers the lowest pattern.
+	static bool keeps(const uint32_t count, const uint32_t pattern, const uint32_t best_count, const uint32_t best_pattern)
+	{
+		if (count != best_count) return count > best_count;
+		if ((pattern == win) != (best_pattern == win)) return best_pattern == win;
+		return pattern < best_pattern;
+	}
+
+	/*
+	Find the bucket Absurdle keeps for one guess, without scattering. Only the touched bins are reset afterwards,
+	so small candidate lists don't pay to clear the whole histogram.
+	*/
+	Move rate(const std::vector<word_t<length>>& candidates, const word_t<length>& guess)
+	{
+		codes.resize(candidates.size());
+
+		Move move;
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			const uint32_t code = get_pattern(guess, candidates[i]);
+			codes[i] = code;
+
+			const uint32_t count = ++histogram[code];
+			if (keeps(count, code, move.kept, move.pattern))
+			{
+				move.kept = count;
+				move.pattern = code;
+			}
+		}
+
+		for (const uint32_t code : codes)
+			histogram[code] = 0;
+
+		return move;
+	}
+
+	/*
+	Return the smallest worst-case depth that is at most limit, or limit + 1 if there is none. Moves are ordered by
+	the size of the bucket they leave, and a move is cut off as soon as even its best case can't beat the best
+	depth found so far. Results are kept in a transposition table, keyed by the candidate list.
+	*/
+	size_t search(const std::vector<word_t<length>>& candidates, const size_t limit, size_t* best_guess = nullptr)
+	{
+		++nodes;
+
+		if (candidates.size() == 1) return 1;
+		if (limit < 2) return limit + 1; // two or more candidates always take at least two guesses
+
+		if (best_guess == nullptr)
+		{
+			const auto it = table.find(candidates);
+			if (it != table.end())
+			{
+				if (it->second.exact) return it->second.depth;
+				if (it->second.depth > limit) return limit + 1;
+			}
+		}
+
+		std::vector<Move> moves(guesses.size());
+		for (size_t i = 0; i < guesses.size(); ++i)
+		{
+			moves[i] = rate(candidates, guesses[i]);
+			moves[i].guess = i;
+		}
+
+		const size_t beam = std::min(beam_width, moves.size());
+		std::partial_sort(moves.begin(), moves.begin() + beam, moves.end(),
+			[](const Move& a, const Move& b) { return a.kept < b.kept; });
+
+		size_t best = limit + 1;
+		Partition<length> partition;
+
+		for (size_t i = 0; i < beam; ++i)
+		{
+			const Move& move = moves[i];
+
+			if (move.kept == candidates.size()) break; // no progress; the rest of the beam is no better
+
+			const size_t lower_bound = 1 + (move.kept == 1 ? 1 : 2);
+			if (lower_bound >= best) continue;
+
+			partition_by_pattern(candidates, guesses[move.guess], partition);
+			const std::vector<word_t<length>> kept(partition.words.begin() + partition.offsets[move.pattern],
+				partition.words.begin() + partition.offsets[move.pattern + 1]);
+
+			const size_t depth = 1 + search(kept, best - 2);
+			if (depth < best)
+			{
+				best = depth;
+				if (best_guess != nullptr) *best_guess = move.guess;
+				if (best == 2) break; // can't do better with two or more candidates
+			}
+		}
+
+		table.insert_or_assign(candidates, Table_entry{ best, best <= limit });
+		return best;
+	}
+
+	const std::vector<word_t<length>> guesses;
+	const size_t beam_width;
+
+	std::vector<uint32_t> histogram;
+	std::vector<uint32_t> codes;
+	std::unordered_map<std::vector<word_t<length>>, Table_entry, Candidates_hash> table;
+	size_t nodes = 0;
+};
+
+// Play one game of Absurdle, and return the number of guesses it took.
+template<size_t length>
+size_t play_absurdle(const std::vector<word_t<length>>& answers, const std::vector<word_t<length>>& guesses, const size_t beam_width = detail::absurdle_beam_width)
+{
+	Absurdle_solver<length> solver{ guesses, beam_width };
+
+	std::vector<word_t<length>> candidates = answers;
+	Partition<length> partition;
+
+	for (size_t guess_n = 1; ; ++guess_n)
+	{
+		const auto [guess, depth] = solver.best_guess(candidates);
+
+		if (candidates.size() == 1)
+		{
+			std::cout << "Guess " << guess_n << ": " << guess << ", solved.\n";
+			return guess_n;
+		}
+
+		if (depth > detail::absurdle_max_depth)
+		{
+			std::cout << "No solution within " << detail::absurdle_max_depth << " guesses, " << candidates.size() << " candidates left.\n";
+			return 0;
+		}
+
+		const uint32_t pattern = solver.kept_pattern(candidates, guess);
+		partition_by_pattern(candidates, guess, partition);
+		candidates.assign(partition.words.begin() + partition.offsets[pattern],
+			partition.words.begin() + partition.offsets[pattern + 1]);
+
+		std::cout << "Guess " << guess_n << ": " << guess << ", " << candidates.size() << " candidates left, solvable in "
+			<< depth << " (" << solver.nodes_searched() << " positions searched)\n";
+	}
+}
+
+void test_absurdle(const size_t beam_width = detail::absurdle_beam_width)
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	const auto start_time = current_time_in_us();
+
+	const size_t guesses = play_absurdle(dictionary, dictionary, beam_width);
+
+	const auto elapsed_time = current_time_in_us() - start_time;
+
+	std::cout << "\nSolved Absurdle in " << guesses << " guesses, " << elapsed_time / 1'000 << " ms elapsed\n";
+}
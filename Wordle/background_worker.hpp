@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/*
+One worker thread that runs the latest job it was given. Submitting a job replaces any job that hasn't started
+yet, and a result is only handed back if no newer job was submitted since, so the caller always sees the
+answer to its latest question, and never waits for answers to stale ones.
+*/
+template<typename Result>
+class Background_worker
+{
+public:
+	Background_worker() : worker{ [this] { work(); } } {}
+
+	~Background_worker()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			stopping = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	Background_worker(const Background_worker&) = delete;
+	Background_worker& operator=(const Background_worker&) = delete;
+
+	void submit(std::function<Result()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			pending = std::move(job);
+			++submitted;
+		}
+		wake.notify_one();
+	}
+
+	// Forget the job in flight, if any, so its result is never handed back.
+	void cancel()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		pending = nullptr;
+		++submitted;
+		finished = submitted;
+	}
+
+	// Whether the latest job's result is still to come.
+	bool busy() const
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		return finished != submitted;
+	}
+
+	// If the latest job has finished and its result hasn't been taken yet, move it into result and return true.
+	bool take(Result& result)
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (!has_result || published != submitted) return false;
+
+		result = std::move(latest);
+		has_result = false;
+		return true;
+	}
+
+private:
+	void work()
+	{
+		std::unique_lock<std::mutex> lock{ mutex };
+		while (true)
+		{
+			wake.wait(lock, [this] { return stopping || pending != nullptr; });
+			if (stopping) return;
+
+			std::function<Result()> job = std::move(pending);
+			pending = nullptr;
+			const uint64_t generation = submitted;
+
+			lock.unlock();
+			Result result = job();
+			lock.lock();
+
+			if (generation == submitted)
+			{
+				latest = std::move(result);
+				has_result = true;
+				published = generation;
+				finished = generation;
+			}
+		}
+	}
+
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+
+	std::function<Result()> pending;
+	uint64_t submitted = 0; // generation of the latest job
+	uint64_t finished = 0; // generation of the latest job that is done, or cancelled
+	uint64_t published = 0; // generation of the result in latest
+
+	Result latest{};
+	bool has_result = false;
+	bool stopping = false;
+
+	std::thread worker; // last, so it starts after everything it uses is constructed
+};
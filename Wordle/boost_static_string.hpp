@@ -227,6 +227,9 @@ namespace boost {
 #include <functional>
 #include <initializer_list>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <type_traits>
 
 namespace boost {
@@ -1198,6 +1201,15 @@ defined(BOOST_STATIC_STRING_NO_PTR_COMP_FUNCTIONS)
 			  assign(other);
 			}
 
+			/** Assign to the string.
+
+				Copy assignment: a plain copy of the members, as the
+				implicit one was, declared so that a user-declared copy
+				constructor doesn't deprecate it.
+			*/
+			basic_static_string&
+			operator=(const basic_static_string&) = default;
+
 			/** Constructor.
 
 				Copy constructor.
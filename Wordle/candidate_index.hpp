@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "wordle.hpp"
+
+/*
+An index over a fixed answer list. For every (position, letter) pair, we keep a posting list: the sorted
+indexes of every answer with that letter in that position.
+
+A set of green letters can then be resolved by intersecting a few short lists, instead of running
+green_filter() over every answer once per green letter.
+*/
+class Candidate_index
+{
+public:
+	using posting_list = std::vector<uint32_t>;
+
+	// One char per position, or 0 if that position has no green letter.
+	using greens_t = std::array<char, detail::word_length>;
+
+	explicit Candidate_index(const std::vector<string_t>& set_answer_list) : answer_list{ set_answer_list }
+	{
+		for (uint32_t i = 0; i < answer_list.size(); ++i)
+			for (size_t j = 0; j < detail::word_length; ++j)
+				postings[j][answer_list[i][j] - detail::letter_a].push_back(i);
+	}
+
+	const posting_list& lookup(const size_t position, const char c) const
+	{
+		return postings[position][c - detail::letter_a];
+	}
+
+	// Return every answer that has all of the given green letters, in answer list order.
+	std::vector<string_t> green_candidates(const greens_t& greens) const
+	{
+		std::vector<const posting_list*> lists;
+		for (size_t i = 0; i < detail::word_length; ++i)
+			if (greens[i] != 0)
+				lists.push_back(&lookup(i, greens[i]));
+
+		if (lists.empty()) return answer_list;
+
+		// Intersect shortest-first, so every intermediate result is as small as possible.
+		std::sort(lists.begin(), lists.end(), [](const posting_list* a, const posting_list* b) { return a->size() < b->size(); });
+
+		posting_list matches = *lists[0];
+		for (size_t i = 1; i < lists.size() && !matches.empty(); ++i)
+			matches = intersect(matches, *lists[i]);
+
+		std::vector<string_t> candidates;
+		candidates.reserve(matches.size());
+		for (const uint32_t index : matches)
+			candidates.push_back(answer_list[index]);
+
+		return candidates;
+	}
+
+	/*
+	Galloping intersection. For each element of the short list, step through the long list in
+	exponentially growing strides until we pass it, then binary search the last stride. This is
+	O(small * log(large / small)), which beats a linear merge when the lists differ a lot in size.
+	*/
+	static posting_list intersect(const posting_list& small, const posting_list& large)
+	{
+		posting_list result;
+		result.reserve(small.size());
+
+		auto it = large.begin();
+		for (const uint32_t x : small)
+		{
+			size_t step = 1;
+			auto hi = it;
+			while (hi != large.end() && *hi < x)
+			{
+				it = hi;
+				hi = (size_t(large.end() - hi) > step) ? hi + step : large.end();
+				step *= 2;
+			}
+
+			it = std::lower_bound(it, hi, x);
+			if (it == large.end()) break;
+			if (*it == x) result.push_back(x);
+		}
+
+		return result;
+	}
+
+private:
+	const std::vector<string_t> answer_list;
+
+	std::array<std::array<posting_list, 26>, detail::word_length> postings;
+};
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "mapped_file.hpp"
+#include "utility.hpp"
+#include "word_set.hpp"
+#include "wordle.hpp"
+
+/*
+A parallel loader for word count corpora like norvig_count_1w.txt, with one "word<tab>count" per line. The
+file is memory mapped and split into chunks on line boundaries. The chunks are parsed in parallel, and only
+words of the requested length are kept.
+*/
+
+#ifndef WORDLE_CORPUS_FILE
+#define WORDLE_CORPUS_FILE "../Wordle/norvig_count_1w.txt"
+#endif
+
+namespace detail
+{
+	const std::string norvig_filename = WORDLE_CORPUS_FILE;
+
+	constexpr size_t chunks_per_thread = 4; // more chunks than threads, so one slow chunk doesn't hold up the rest
+}
+
+template<size_t length>
+struct Word_count
+{
+	word_t<length> word;
+	size_t count;
+};
+
+/*
+Call f(line_begin, line_end) for every line in [begin, end). Newlines are found 16 bytes at a time: one compare
+and one movemask give a bitmask of every newline in the block.
+*/
+template<typename F>
+void for_each_line(const char* const begin, const char* const end, F&& f)
+{
+	const char* line = begin;
+	const char* p = begin;
+
+#if defined(__SSE2__) || defined(_M_X64)
+	const __m128i newline = _mm_set1_epi8('\n');
+	for (; end - p >= 16; p += 16)
+	{
+		uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), newline)));
+		while (mask != 0)
+		{
+			const char* const line_end = p + count_trailing_zeros(mask);
+			f(line, line_end);
+			line = line_end + 1;
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	for (; p < end; ++p)
+	{
+		if (*p != '\n') continue;
+		f(line, p);
+		line = p + 1;
+	}
+
+	if (line < end) f(line, end); // the last line has no newline
+}
+
+/*
+Parse one line. Returns false unless the word is exactly `length` letters. Uppercasing and letter validation
+are branch-free.
+*/
+template<size_t length>
+bool parse_word_count(const char* const begin, const char* const end, Word_count<length>& word_count)
+{
+	const char* word_end = begin;
+	while (word_end < end && *word_end != '\t' && *word_end != ' ') ++word_end;
+	if (size_t(word_end - begin) != length) return false;
+
+	char letters[length];
+	uint32_t invalid = 0;
+	for (size_t i = 0; i < length; ++i)
+	{
+		const uint8_t c = uint8_t(begin[i]);
+		const uint8_t upper = uint8_t(c - (uint8_t(c - 'a') < 26) * ('a' - 'A'));
+		invalid |= uint8_t(upper - detail::letter_a) >= 26;
+		letters[i] = char(upper);
+	}
+	if (invalid) return false;
+
+	size_t count = 0;
+	for (const char* p = word_end; p < end; ++p)
+	{
+		const uint8_t digit = uint8_t(*p - '0');
+		if (digit < 10) count = count * 10 + digit;
+	}
+
+	word_count.word.assign(letters, length);
+	word_count.count = count;
+	return true;
+}
+
+// Return every word of this length in the file, with its count, in file order.
+template<size_t length = detail::word_length>
+std::vector<Word_count<length>> load_word_counts(const std::string& filename = detail::norvig_filename)
+{
+	const Mapped_file file{ filename };
+	if (!file.is_open())
+	{
+		std::cout << "Could not load " << filename << '\n';
+		return {};
+	}
+
+	const char* const file_end = file.data() + file.size();
+
+	// Split the file into chunks, moving each split point forward to the start of the next line.
+	const size_t chunk_count = thread_count() * detail::chunks_per_thread;
+	std::vector<const char*> bounds{ file.data() };
+	for (size_t i = 1; i < chunk_count; ++i)
+	{
+		const char* p = std::max(bounds.back(), file.data() + file.size() * i / chunk_count);
+		const void* newline = std::memchr(p, '\n', size_t(file_end - p));
+		bounds.push_back(newline == nullptr ? file_end : static_cast<const char*>(newline) + 1);
+	}
+	bounds.push_back(file_end);
+
+	std::vector<std::vector<Word_count<length>>> chunks(chunk_count);
+
+	parallel_for(chunk_count, [&](const size_t begin, const size_t end, const size_t)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				for_each_line(bounds[i], bounds[i + 1], [&](const char* const line, const char* const line_end)
+					{
+						Word_count<length> word_count;
+						if (parse_word_count(line, line_end, word_count))
+							chunks[i].push_back(word_count);
+					});
+			}
+		});
+
+	size_t total = 0;
+	for (const auto& chunk : chunks)
+		total += chunk.size();
+
+	std::vector<Word_count<length>> word_counts;
+	word_counts.reserve(total);
+	for (const auto& chunk : chunks)
+		word_counts.insert(word_counts.end(), chunk.begin(), chunk.end());
+
+	return word_counts;
+}
+
+// As above, merged into one flat array sorted by word.
+template<size_t length = detail::word_length>
+std::vector<Word_count<length>> load_sorted_word_counts(const std::string& filename = detail::norvig_filename)
+{
+	std::vector<Word_count<length>> word_counts = load_word_counts<length>(filename);
+
+	std::sort(word_counts.begin(), word_counts.end(),
+		[](const Word_count<length>& a, const Word_count<length>& b) { return a.word < b.word; });
+
+	return word_counts;
+}
+
+// The most frequent words of this length. The Norvig counts are sorted by frequency already.
+template<size_t length = detail::word_length>
+std::vector<word_t<length>> load_norvig_words(const size_t word_list_size)
+{
+	const std::vector<Word_count<length>> word_counts = load_word_counts<length>();
+
+	std::vector<word_t<length>> word_list;
+	word_list.reserve(std::min(word_list_size, word_counts.size()));
+
+	for (size_t i = 0; i < word_counts.size() && word_list.size() < word_list_size; ++i)
+		word_list.push_back(word_counts[i].word);
+
+	return word_list;
+}
+
+// Word counts keyed by a Word_set: counts[i] is the count of words[i].
+template<size_t length>
+struct Word_frequencies
+{
+	Word_set<length> words;
+	std::vector<size_t> counts;
+
+	size_t count(const word_t<length>& word) const
+	{
+		const size_t index = words.index_of(word);
+		return index == Word_set<length>::npos ? 0 : counts[index];
+	}
+};
+
+template<size_t length = detail::word_length>
+Word_frequencies<length> load_norvig_words_with_frequencies()
+{
+	const std::vector<Word_count<length>> word_counts = load_word_counts<length>();
+
+	std::vector<word_t<length>> words;
+	for (const auto& word_count : word_counts)
+	{
+		const auto& word = word_count.word;
+		if (contains(word, 'A') ||
+			contains(word, 'E') ||
+			contains(word, 'I') ||
+			contains(word, 'O') ||
+			contains(word, 'U') ||
+			contains(word, 'Y'))
+		{
+			words.push_back(word);
+		}
+	}
+
+	Word_frequencies<length> frequencies{ Word_set<length>{ words }, {} };
+	frequencies.counts.resize(frequencies.words.size());
+
+	for (const auto& [word, count] : word_counts)
+	{
+		// as with std::map::insert, the first (and highest) count of a repeated word wins
+		const size_t index = frequencies.words.index_of(word);
+		if (index != Word_set<length>::npos && frequencies.counts[index] == 0)
+			frequencies.counts[index] = count;
+	}
+
+	return frequencies;
+}
+
+void test_loader()
+{
+	const auto start_time = current_time_in_us();
+
+	const std::vector<Word_count<detail::word_length>> word_counts = load_sorted_word_counts();
+
+	const auto elapsed_time = current_time_in_us() - start_time;
+
+	std::cout << "Loaded " << word_counts.size() << " words in " << elapsed_time / 1'000 << " ms (" << elapsed_time << " us)\n";
+}
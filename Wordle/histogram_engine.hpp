@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pattern_kernel.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+#include "words.hpp"
+
+/*
+Pattern histograms for many guesses against many answers. Scoring every guess means one 243-bin histogram per
+guess, and a naive loop streams the whole answer list through the cache once per guess. Instead, guesses and
+answers are cut into tiles: each answer tile is loaded once and reused by every guess in the guess tile, while
+that tile's histograms stay resident.
+
+Tiles of guesses are spread across the threads of a pool, which callers keep from one call to the next, and each
+thread owns its histograms, so there is no sharing. Bins are 16-bit, which halves the histograms' footprint, and
+limits a single call to 65535 answers.
+
+It backs every entropy ranking of 5-letter words: the select_guess_entropy() overloads here, which play() uses when
+it picks guesses by entropy, and rank_guesses_by_entropy(), for the GUI's suggestions and the CLI's solve command.
+Weighted by priors, the selector sums weights instead of counts, so it takes the kernel's patterns without the
+histograms.
+*/
+
+namespace detail
+{
+	constexpr size_t patterns_per_guess = pattern_count(word_length);
+
+	constexpr size_t guess_tile = 64; // 64 histograms of 243 16-bit bins is 31 KB
+	constexpr size_t answer_tile = 4096; // 5 columns of 4 KB is 20 KB, and the pattern buffer another 4 KB
+	constexpr size_t sparse_answers = 96; // up to this many, score_guesses() skips the histograms' empty bins
+
+	static_assert(answer_tile % answer_block_padding == 0, "answer tiles must start on a vector boundary");
+}
+
+using histogram_t = std::array<uint16_t, detail::patterns_per_guess>;
+
+/*
+Call f(guess_index, histogram) once for every guess, from whichever thread of the pool built that histogram. f
+must be safe to call concurrently for different guesses. Throws std::length_error if there are more answers than a
+bin can count.
+*/
+template<typename F>
+void for_each_histogram(const std::vector<string_t>& guesses, const Answer_block& answers, Thread_pool& pool, F&& f)
+{
+	using namespace detail;
+
+	if (answers.size() > std::numeric_limits<uint16_t>::max())
+		throw std::length_error("for_each_histogram: " + std::to_string(answers.size()) + " answers overflow 16-bit bins");
+
+	const size_t tiles = (guesses.size() + guess_tile - 1) / guess_tile;
+
+	pool.parallel_for(tiles, [&](const size_t begin, const size_t end, const size_t)
+		{
+			std::vector<histogram_t> histograms(guess_tile);
+			std::vector<uint8_t> codes(answer_tile);
+			histogram_t odd; // odd answers count here, so runs of one pattern don't serialize on one bin
+
+			for (size_t tile = begin; tile < end; ++tile)
+			{
+				const size_t first_guess = tile * guess_tile;
+				const size_t tile_size = std::min(guess_tile, guesses.size() - first_guess);
+
+				for (size_t g = 0; g < tile_size; ++g)
+					histograms[g].fill(0);
+
+				for (size_t first_answer = 0; first_answer < answers.size(); first_answer += answer_tile)
+				{
+					const size_t count = std::min(answer_tile, answers.size() - first_answer);
+
+					for (size_t g = 0; g < tile_size; ++g)
+					{
+						compute_patterns(guesses[first_guess + g], answers, codes.data(), first_answer, first_answer + count);
+
+						histogram_t& histogram = histograms[g];
+						odd.fill(0);
+
+						size_t i = 0;
+						for (; i + 1 < count; i += 2)
+						{
+							++histogram[codes[i]];
+							++odd[codes[i + 1]];
+						}
+						if (i < count) ++histogram[codes[i]];
+
+						for (size_t p = 0; p < patterns_per_guess; ++p)
+							histogram[p] += odd[p];
+					}
+				}
+
+				for (size_t g = 0; g < tile_size; ++g)
+					f(first_guess + g, histograms[g]);
+			}
+		});
+}
+
+struct Guess_score
+{
+	double entropy = 0.0; // bits of information, on average
+	uint32_t largest_bucket = 0; // candidates left in the worst case
+	bool is_candidate = false; // whether this guess could be the answer
+};
+
+using ranked_guesses_t = std::vector<std::pair<double, string_t>>;
+
+/*
+Score every guess against few answers. Most bins of a histogram would stay empty, and clearing and scanning all of
+them costs more than the kernel, so only the bins the answers fall into are read, and then cleared.
+*/
+void score_guesses_sparse(const std::vector<string_t>& guesses, const Answer_block& answers, Thread_pool& pool, std::vector<Guess_score>& scores)
+{
+	const size_t n = answers.size();
+
+	pool.parallel_for(guesses.size(), [&](const size_t begin, const size_t end, const size_t)
+		{
+			std::vector<uint8_t> codes(answers.padded_size());
+			histogram_t histogram{};
+
+			for (size_t g = begin; g < end; ++g)
+			{
+				compute_patterns(guesses[g], answers, codes.data());
+				for (size_t i = 0; i < n; ++i)
+					++histogram[codes[i]];
+
+				double sum = 0;
+				uint32_t largest = 0;
+				for (size_t i = 0; i < n; ++i)
+				{
+					const uint32_t count = histogram[codes[i]];
+					if (count == 0) continue; // a bin already read
+					histogram[codes[i]] = 0;
+
+					if (count > 1) sum += count * std::log2(double(count));
+					largest = std::max(largest, count);
+				}
+
+				scores[g].entropy = std::log2(double(n)) - sum / n;
+				scores[g].largest_bucket = largest;
+				scores[g].is_candidate = false;
+				for (size_t i = 0; i < n; ++i)
+					scores[g].is_candidate |= codes[i] == detail::patterns_per_guess - 1;
+			}
+		});
+}
+
+// Score every guess against the candidates, aligned with guesses.
+std::vector<Guess_score> score_guesses(const std::vector<string_t>& candidates, const std::vector<string_t>& guesses, Thread_pool& pool)
+{
+	const Answer_block answers{ candidates };
+	std::vector<Guess_score> scores(guesses.size());
+
+	if (candidates.size() <= detail::sparse_answers)
+	{
+		score_guesses_sparse(guesses, answers, pool, scores);
+		return scores;
+	}
+
+	for_each_histogram(guesses, answers, pool, [&](const size_t guess, const histogram_t& histogram)
+		{
+			scores[guess].entropy = pattern_entropy(histogram, candidates.size());
+			scores[guess].largest_bucket = *std::max_element(histogram.begin(), histogram.end());
+			scores[guess].is_candidate = histogram[detail::patterns_per_guess - 1] > 0;
+		});
+
+	return scores;
+}
+
+// A guess's entropy, plus the chance of winning outright if it could be the answer, which breaks ties its way.
+double entropy_score(const Guess_score& score, const size_t candidates)
+{
+	return score.entropy + (score.is_candidate ? 1.0 / candidates : 0.0);
+}
+
+/*
+Every guess that would tell us something about the candidates, with its entropy score, best first. A guess that
+leaves them all in one bucket, and can't be the answer, is left out.
+*/
+ranked_guesses_t rank_guesses_by_entropy(const std::vector<string_t>& candidates, const std::vector<string_t>& guesses, Thread_pool& pool)
+{
+	const std::vector<Guess_score> scores = score_guesses(candidates, guesses, pool);
+
+	ranked_guesses_t ranked;
+	ranked.reserve(guesses.size());
+	for (size_t i = 0; i < guesses.size(); ++i)
+		if (scores[i].largest_bucket < candidates.size() || scores[i].is_candidate)
+			ranked.push_back({ entropy_score(scores[i], candidates.size()), guesses[i] });
+
+	std::stable_sort(ranked.begin(), ranked.end(),
+		[](const auto& a, const auto& b) { return a.first > b.first; });
+
+	return ranked;
+}
+
+/*
+The unweighted entropy selector, for 5-letter words: the same choice as the template in wordle.hpp, which serves
+the other lengths, built on the histogram engine. Ties go to the guess that comes first.
+*/
+string_t select_guess_entropy(const std::vector<string_t>& candidates, const std::vector<string_t>& dictionary, Thread_pool& pool)
+{
+	// one candidate's a sure win, and of two, the first wins half the time, as well as any split
+	if (!candidates.empty() && candidates.size() <= 2) return candidates[0];
+
+	const std::vector<Guess_score> scores = score_guesses(candidates, dictionary, pool);
+
+	size_t best = 0;
+	for (size_t i = 1; i < scores.size(); ++i)
+		if (entropy_score(scores[i], candidates.size()) > entropy_score(scores[best], candidates.size()))
+			best = i;
+
+	return dictionary[best];
+}
+
+/*
+The weighted entropy selector, for 5-letter words: the same choice as the template in wordle.hpp. The kernel
+writes each guess's patterns against every candidate, and one pass over them sums the weights of each pattern.
+*/
+string_t select_guess_entropy(const std::vector<string_t>& candidates, const std::vector<float>& priors, const std::vector<string_t>& dictionary,
+	Thread_pool& pool)
+{
+	if (candidates.size() == 1) return candidates[0];
+
+	double total_weight = 0;
+	for (const float prior : priors)
+		total_weight += prior;
+
+	const Answer_block answers{ candidates };
+	std::vector<Best_guess> best(pool.size());
+
+	pool.parallel_for(dictionary.size(), [&](const size_t begin, const size_t end, const size_t thread)
+		{
+			std::vector<uint8_t> codes(answers.padded_size());
+			std::array<float, detail::patterns_per_guess> weights;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				compute_patterns(dictionary[i], answers, codes.data());
+
+				weights.fill(0.0f);
+				for (size_t w = 0; w < candidates.size(); ++w)
+					weights[codes[w]] += priors[w];
+
+				best[thread].offer(weighted_entropy_score(weights, total_weight), i);
+			}
+		});
+
+	return dictionary[Best_guess::of(best)];
+}
+
+void test_histogram_engine()
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	const Answer_block answers{ dictionary };
+
+	// naive: one guess at a time, each streaming every answer
+	std::vector<histogram_t> expected(dictionary.size());
+	auto start_time = current_time_in_us();
+	{
+		std::vector<uint8_t> codes(answers.padded_size());
+		for (size_t g = 0; g < dictionary.size(); ++g)
+		{
+			expected[g].fill(0);
+			compute_patterns(dictionary[g], answers, codes.data());
+			for (size_t i = 0; i < answers.size(); ++i)
+				++expected[g][codes[i]];
+		}
+	}
+	const auto naive_time = std::max<int64_t>(1, current_time_in_us() - start_time);
+
+	Thread_pool pool;
+	std::atomic<size_t> mismatches{ 0 };
+	start_time = current_time_in_us();
+	for_each_histogram(dictionary, answers, pool, [&](const size_t guess, const histogram_t& histogram)
+		{
+			if (histogram != expected[guess]) ++mismatches;
+		});
+	const auto blocked_time = std::max<int64_t>(1, current_time_in_us() - start_time);
+
+	const double count = double(dictionary.size()) * dictionary.size();
+	std::cout << "Naive: " << naive_time / 1'000 << " ms (" << count / naive_time / 1'000 << " billion patterns/s)\n"
+		<< "Blocked, " << pool.size() << " threads: " << blocked_time / 1'000 << " ms (" << count / blocked_time / 1'000 << " billion patterns/s)\n"
+		<< "Mismatched histograms: " << mismatches << '\n';
+}
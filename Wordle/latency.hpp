@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utility.hpp"
+
+/*
+Where the time goes between an input event and the window showing its result. Each event is timed in stages:
+filtering the candidates, scoring guesses for them (in the background, from submission until the result is
+picked up), laying out the lists' text, and everything up to the next display(). The last samples of each
+stage are kept, for a rolling p50 and p99; every sample can also be logged to a file, one line each.
+*/
+
+namespace detail
+{
+	constexpr size_t latency_samples = 256; // per stage
+
+	constexpr char latency_filename[] = "wordle_latency.tsv";
+}
+
+enum class Latency_stage { filter, score, text, display, count };
+
+class Latency_tracker
+{
+public:
+	static constexpr size_t stage_count = size_t(Latency_stage::count);
+
+	// Log every sample from now on: event number, stage and microseconds, tab-separated.
+	bool open_log(const std::string& filename = detail::latency_filename)
+	{
+		log.open(filename, std::ios::trunc);
+		if (log) log << "event\tstage\tus\n";
+		return bool(log);
+	}
+
+	// An input event arrived. Returns its number, for stages that finish after later events.
+	uint64_t begin_event()
+	{
+		event_start = current_time_in_us();
+		displayed_since_event = false;
+		return ++event;
+	}
+
+	uint64_t current_event() const { return event; }
+
+	void add(const Latency_stage stage, const int64_t us) { add(stage, us, event); }
+
+	void add(const Latency_stage stage, const int64_t us, const uint64_t for_event)
+	{
+		auto& stage_samples = samples[size_t(stage)];
+		stage_samples[next[size_t(stage)]++ % detail::latency_samples] = us;
+
+		if (log) log << for_event << '\t' << name(stage) << '\t' << us << '\n';
+	}
+
+	// The window was just displayed. The first display after an event ends that event's display stage.
+	void displayed()
+	{
+		if (event == 0 || displayed_since_event) return;
+
+		displayed_since_event = true;
+		add(Latency_stage::display, current_time_in_us() - event_start);
+	}
+
+	// The pth percentile (0 to 100) of the stage's recent samples, in microseconds, or 0 before there are any.
+	int64_t percentile(const Latency_stage stage, const double p) const
+	{
+		const size_t n = std::min(next[size_t(stage)], detail::latency_samples);
+		if (n == 0) return 0;
+
+		std::vector<int64_t> sorted(samples[size_t(stage)].begin(), samples[size_t(stage)].begin() + n);
+		const size_t k = std::min(n - 1, size_t(p / 100.0 * n));
+		std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+		return sorted[k];
+	}
+
+	// One line per stage, in milliseconds, for the overlay.
+	std::vector<std::string> summary() const
+	{
+		std::vector<std::string> lines{ "ms        p50    p99" };
+		for (size_t stage = 0; stage < stage_count; ++stage)
+		{
+			char line[64];
+			snprintf(line, sizeof(line), "%-8s %6.2f %6.2f", name(Latency_stage(stage)),
+				percentile(Latency_stage(stage), 50) / 1000.0, percentile(Latency_stage(stage), 99) / 1000.0);
+			lines.push_back(line);
+		}
+		return lines;
+	}
+
+	static const char* name(const Latency_stage stage)
+	{
+		constexpr const char* names[] = { "filter", "score", "text", "display" };
+		return names[size_t(stage)];
+	}
+
+private:
+	std::array<std::array<int64_t, detail::latency_samples>, stage_count> samples{};
+	std::array<size_t, stage_count> next{}; // samples taken so far, per stage
+
+	uint64_t event = 0;
+	int64_t event_start = 0;
+	bool displayed_since_event = true;
+
+	std::ofstream log;
+};
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "histogram_engine.hpp"
+#include "pattern_matrix.hpp"
+#include "utility.hpp"
+#include "word_set.hpp"
+#include "wordle.hpp"
+
+/*
+Guess selection with lookahead. select_guess() is greedy: it takes the best guess for this turn alone. Here, every
+guess is first given a cheap one-ply score: the expected number of guesses left, with each bucket it leaves
+costed by a rough estimate from its size. The best beam_width guesses are then searched deeper: each of their
+buckets is solved the same way, one ply less deep, and the guess with the fewest expected guesses wins.
+
+Candidates are columns of one pattern matrix built per turn, so partitioning a candidate set is table lookups.
+The same bucket turns up under different guesses, so results are memoized by a hash of its candidates, and the
+beam members are searched in parallel.
+*/
+
+namespace detail
+{
+	constexpr size_t lookahead_beam_width = 8;
+	constexpr size_t lookahead_depth = 2;
+	constexpr double bits_per_guess = 4.6; // roughly what a good guess reveals, for estimating buckets beyond the search
+}
+
+class Lookahead_search
+{
+public:
+	/*
+	The matrix has a row per guess and a column per candidate; candidate_guesses gives the row of each candidate
+	that is also a guess, or npos.
+	*/
+	Lookahead_search(const Pattern_matrix& set_matrix, std::vector<size_t> set_candidate_guesses, const size_t set_beam_width) :
+		matrix{ set_matrix },
+		candidate_guesses{ std::move(set_candidate_guesses) },
+		beam_width{ set_beam_width },
+		estimates(matrix.answer_count() + 1),
+		weighted(matrix.answer_count() + 1)
+	{
+		/*
+		Outside the search, n candidates are guessed at: never fewer than if the next guess could be the answer
+		and would split the rest perfectly, 2 - 1/n.
+		*/
+		for (size_t n = 1; n < estimates.size(); ++n)
+		{
+			estimates[n] = std::max(2.0 - 1.0 / n, 1.0 + std::log2(double(n)) / detail::bits_per_guess);
+			weighted[n] = n * estimates[n];
+		}
+	}
+
+	static constexpr size_t npos = size_t(-1);
+
+	/*
+	A set of candidates: columns [begin, end) of a guess-by-candidate table with the given row stride. ids holds
+	the candidate in each column of the table.
+	*/
+	struct Set
+	{
+		const uint8_t* table;
+		size_t stride;
+		const uint32_t* ids;
+		size_t begin, end;
+
+		size_t size() const { return end - begin; }
+		const uint8_t* row(const size_t guess) const { return table + guess * stride + begin; }
+	};
+
+	// The whole matrix, which ids must number.
+	Set everything(const std::vector<uint32_t>& ids) const { return { matrix.data(), matrix.answer_count(), ids.data(), 0, ids.size() }; }
+
+	// Per-thread working memory. The counts are kept zeroed between uses.
+	struct Scratch
+	{
+		std::array<uint32_t, detail::patterns_per_guess> counts{};
+		std::array<uint32_t, detail::patterns_per_guess> odd{};
+		std::array<uint8_t, detail::patterns_per_guess + 1> touched{};
+	};
+
+	/*
+	The one-ply cost of a guess against the set: 1 for the guess itself, plus the estimate for each bucket it
+	leaves, weighted by the bucket's share of the set. The all-green bucket costs nothing more.
+	*/
+	double one_ply(const Set& set, const size_t guess, Scratch& scratch) const
+	{
+		const uint8_t* const row = set.row(guess);
+		const size_t n = set.size();
+		auto& counts = scratch.counts;
+		double sum = 0.0;
+		uint32_t wins;
+
+		if (n < detail::patterns_per_guess)
+		{
+			// Few candidates: note which bins were used, without a branch, and visit only those.
+			size_t touched = 0;
+			for (size_t k = 0; k < n; ++k)
+			{
+				scratch.touched[touched] = row[k];
+				touched += counts[row[k]]++ == 0;
+			}
+
+			wins = counts[win];
+			for (size_t i = 0; i < touched; ++i)
+			{
+				sum += weighted[counts[scratch.touched[i]]];
+				counts[scratch.touched[i]] = 0;
+			}
+		}
+		else
+		{
+			// Many: count odd and even candidates apart, so runs of one pattern don't wait on one bin.
+			size_t k = 0;
+			for (; k + 1 < n; k += 2)
+			{
+				++counts[row[k]];
+				++scratch.odd[row[k + 1]];
+			}
+			if (k < n) ++counts[row[k]];
+
+			wins = counts[win] + scratch.odd[win];
+			for (size_t p = 0; p < detail::patterns_per_guess; ++p)
+			{
+				sum += weighted[counts[p] + scratch.odd[p]];
+				counts[p] = 0;
+				scratch.odd[p] = 0;
+			}
+		}
+
+		return 1.0 + (sum - weighted[wins]) / n;
+	}
+
+	// The one-ply cost of guesses [first, last) against the set.
+	void one_ply(const Set& set, const size_t first, const size_t last, Scratch& scratch, double* const costs) const
+	{
+		for (size_t g = first; g < last; ++g)
+			costs[g - first] = one_ply(set, g, scratch);
+	}
+
+	// The expected number of guesses to solve the set, counting the next one, searching depth plies.
+	double expected_guesses(const Set& set, const size_t depth, Scratch& scratch)
+	{
+		if (set.size() <= 2 || depth == 0) return estimates[set.size()]; // exact for 1 or 2: 1 or 1.5
+
+		const uint64_t key = hash(set, depth);
+		{
+			std::lock_guard<std::mutex> lock{ memo_mutex };
+			const auto it = memo.find(key);
+			if (it != memo.end()) return it->second;
+		}
+
+		// Any guess that can't be the answer costs at least 2, so a member that does as well settles it.
+		double best = (depth == 1) ? best_member(set, scratch) : HUGE_VAL;
+		if (best > 2.0)
+		{
+			std::vector<double> costs(matrix.guess_count());
+			one_ply(set, 0, costs.size(), scratch, costs.data());
+
+			best = *std::min_element(costs.begin(), costs.end());
+			if (depth > 1)
+			{
+				for (const size_t guess : beam(costs))
+					best = std::min(best, expected_after(set, guess, depth, scratch));
+			}
+		}
+
+		std::lock_guard<std::mutex> lock{ memo_mutex };
+		memo[key] = best;
+		return best;
+	}
+
+	/*
+	The expected number of guesses to solve the set if this guess comes next, searching its buckets depth - 1
+	plies. The buckets worth searching are gathered into a table of their own, one bucket after another, so each
+	is a contiguous range of every row, instead of a scatter of columns across a much wider one.
+	*/
+	double expected_after(const Set& set, const size_t guess, const size_t depth, Scratch& scratch)
+	{
+		const uint8_t* const row = set.row(guess);
+		const size_t n = set.size();
+
+		// histogram and scatter, as in partition_by_pattern()
+		std::vector<uint32_t> offsets(detail::patterns_per_guess + 1, 0);
+		for (size_t k = 0; k < n; ++k)
+			++offsets[row[k] + 1];
+		for (size_t p = 0; p < detail::patterns_per_guess; ++p)
+			offsets[p + 1] += offsets[p];
+
+		double expected = 1.0;
+		std::vector<uint32_t> searched(detail::patterns_per_guess + 1, 0); // offsets of the buckets to search, in the new table
+		for (size_t p = 0; p < win; ++p)
+		{
+			const uint32_t size = offsets[p + 1] - offsets[p];
+			const bool search = size > 2 && depth > 1;
+			searched[p + 1] = searched[p] + (search ? size : 0);
+
+			if (!search) expected += double(size) / n * estimates[size];
+		}
+		searched[win + 1] = searched[win];
+
+		const size_t width = searched[win];
+		if (width == 0) return expected;
+
+		std::vector<uint32_t> columns(width), ids(width);
+		std::vector<uint32_t> cursor(searched.begin(), searched.end() - 1);
+		for (size_t k = 0; k < n; ++k)
+		{
+			const uint8_t p = row[k];
+			if (searched[p + 1] == searched[p]) continue;
+
+			columns[cursor[p]] = uint32_t(set.begin + k);
+			ids[cursor[p]++] = set.ids[set.begin + k];
+		}
+
+		std::vector<uint8_t> table(matrix.guess_count() * width);
+		for (size_t g = 0; g < matrix.guess_count(); ++g)
+		{
+			const uint8_t* const source = set.table + g * set.stride;
+			uint8_t* const target = table.data() + g * width;
+			for (size_t k = 0; k < width; ++k)
+				target[k] = source[columns[k]];
+		}
+
+		for (size_t p = 0; p < win; ++p)
+		{
+			if (searched[p + 1] == searched[p]) continue;
+
+			const Set bucket{ table.data(), width, ids.data(), searched[p], searched[p + 1] };
+			expected += double(bucket.size()) / n * expected_guesses(bucket, depth - 1, scratch);
+		}
+
+		return expected;
+	}
+
+	// The beam_width guesses with the lowest costs, best first.
+	std::vector<size_t> beam(const std::vector<double>& costs) const
+	{
+		std::vector<size_t> order(costs.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+
+		const size_t width = std::min(beam_width, order.size());
+		std::partial_sort(order.begin(), order.begin() + width, order.end(),
+			[&](const size_t a, const size_t b) { return costs[a] < costs[b] || (costs[a] == costs[b] && a < b); });
+		order.resize(width);
+		return order;
+	}
+
+private:
+	static constexpr uint8_t win = uint8_t(detail::patterns_per_guess - 1);
+
+	// The lowest one-ply cost among guesses that could be the answer themselves.
+	double best_member(const Set& set, Scratch& scratch) const
+	{
+		double best = HUGE_VAL;
+		for (size_t k = set.begin; k < set.end; ++k)
+			if (candidate_guesses[set.ids[k]] != npos)
+				best = std::min(best, one_ply(set, candidate_guesses[set.ids[k]], scratch));
+		return best;
+	}
+
+	static uint64_t hash(const Set& set, const size_t depth)
+	{
+		uint64_t h = 14695981039346656037ull ^ depth; // FNV-1a
+		for (size_t k = set.begin; k < set.end; ++k)
+		{
+			h ^= set.ids[k];
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	const Pattern_matrix& matrix;
+	const std::vector<size_t> candidate_guesses;
+	const size_t beam_width;
+	std::vector<double> estimates; // indexed by bucket size
+	std::vector<double> weighted; // n * estimates[n], a bucket's share of the cost, times the set size
+
+	std::mutex memo_mutex;
+	std::unordered_map<uint64_t, double> memo;
+};
+
+/*
+Pick a guess by searching depth plies ahead (1 is the greedy one-ply score alone), keeping the beam_width best
+guesses at each level. The matrix has a row per dictionary word and a column per candidate.
+*/
+string_t select_guess_lookahead(const std::vector<string_t>& candidates, const std::vector<string_t>& dictionary, const Pattern_matrix& matrix,
+	const size_t beam_width = detail::lookahead_beam_width, const size_t depth = detail::lookahead_depth)
+{
+	if (candidates.size() <= 2) return candidates[0];
+
+	const Word_set<> guesses{ dictionary };
+	std::vector<size_t> row_of_word(guesses.size());
+	for (size_t g = 0; g < dictionary.size(); ++g)
+		row_of_word[guesses.index_of(dictionary[g])] = g;
+
+	std::vector<size_t> candidate_guesses(candidates.size(), Lookahead_search::npos);
+	for (size_t c = 0; c < candidates.size(); ++c)
+	{
+		const size_t index = guesses.index_of(candidates[c]);
+		if (index != Word_set<>::npos) candidate_guesses[c] = row_of_word[index];
+	}
+
+	Lookahead_search search{ matrix, std::move(candidate_guesses), beam_width };
+
+	std::vector<uint32_t> ids(candidates.size());
+	std::iota(ids.begin(), ids.end(), 0u);
+	const Lookahead_search::Set set = search.everything(ids);
+
+	std::vector<double> costs(dictionary.size());
+	parallel_for(dictionary.size(), [&](const size_t begin, const size_t end, const size_t)
+		{
+			Lookahead_search::Scratch scratch;
+			search.one_ply(set, begin, end, scratch, costs.data() + begin);
+		});
+
+	const std::vector<size_t> beam = search.beam(costs);
+	if (depth <= 1) return dictionary[beam[0]];
+
+	std::vector<double> expected(beam.size());
+	parallel_for(beam.size(), [&](const size_t begin, const size_t end, const size_t)
+		{
+			Lookahead_search::Scratch scratch;
+			for (size_t i = begin; i < end; ++i)
+				expected[i] = search.expected_after(set, beam[i], depth, scratch);
+		});
+
+	// ties go to the better one-ply score, which comes first in the beam
+	const size_t best = size_t(std::min_element(expected.begin(), expected.end()) - expected.begin());
+	return dictionary[beam[best]];
+}
+
+// The same, building the matrix for these candidates first.
+string_t select_guess_lookahead(const std::vector<string_t>& candidates, const std::vector<string_t>& dictionary,
+	const size_t beam_width = detail::lookahead_beam_width, const size_t depth = detail::lookahead_depth)
+{
+	if (candidates.size() <= 2) return candidates[0];
+
+	return select_guess_lookahead(candidates, dictionary, make_pattern_matrix(dictionary, candidates), beam_width, depth);
+}
+
+/*
+Play one game with lookahead, and return the number of guesses it took, or 0 if it was lost. The search scores
+guesses by the buckets of exact patterns they leave, so the candidates are filtered by the exact pattern too.
+*/
+size_t play_lookahead(const std::vector<string_t>& dictionary, const string_t& answer, const string_t& first_guess,
+	const size_t beam_width = detail::lookahead_beam_width, const size_t depth = detail::lookahead_depth)
+{
+	std::vector<string_t> candidates = dictionary;
+
+	for (size_t guess_n = 0; guess_n < 6; ++guess_n)
+	{
+		const string_t guess = (guess_n == 0) ? first_guess : select_guess_lookahead(candidates, dictionary, beam_width, depth);
+
+		if (guess == answer) return guess_n + 1;
+
+		filter_by_pattern(candidates, guess, answer);
+	}
+
+	std::cout << "Lost on " << answer << ", " << candidates.size() << " candidates left.\n";
+	return 0;
+}
+
+void test_lookahead(const size_t games, const size_t beam_width = detail::lookahead_beam_width, const size_t depth = detail::lookahead_depth)
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words, searching " << depth << " plies with a beam of " << beam_width << '.' << std::endl;
+
+	auto start_time = current_time_in_us();
+
+	// The first guess is the same every game, and the full dictionary is too large to search deeply every time.
+	const string_t first_guess = select_guess_lookahead(dictionary, dictionary, beam_width, 1);
+
+	std::cout << "First guess: " << first_guess << ", " << (current_time_in_us() - start_time) / 1'000 << " ms" << std::endl;
+
+	start_time = current_time_in_us();
+
+	size_t wins = 0;
+	size_t total_guesses = 0;
+
+	for (size_t game = 0; game < games; ++game)
+	{
+		const size_t guesses = play_lookahead(dictionary, dictionary[random_int_from(0, dictionary.size() - 1)], first_guess, beam_width, depth);
+		if (guesses == 0) continue;
+
+		++wins;
+		total_guesses += guesses;
+	}
+
+	const auto elapsed_time = current_time_in_us() - start_time;
+
+	std::cout << "\nPlayed " << games << " games, won " << wins
+		<< " (" << (wins > 0 ? double(total_guesses) / wins : 0.0) << " guesses per win), "
+		<< elapsed_time / 1'000 << " ms elapsed (" << (elapsed_time / std::max<size_t>(1, games)) << " us per game)\n";
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/*
+A map that holds at most a fixed number of entries, and makes room by dropping the one used longest ago.
+Entries live in a list ordered by use, most recent first, and the hash map points into the list, so a lookup
+or an insertion is one hash probe plus a splice.
+*/
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class Lru_cache
+{
+public:
+	explicit Lru_cache(const size_t set_capacity) : capacity{ set_capacity } {}
+
+	// The entry for this key, marked as just used, or nullptr. Counts as a hit or a miss.
+	const Value* find(const Key& key)
+	{
+		const auto it = index.find(key);
+		if (it == index.end())
+		{
+			++miss_count;
+			return nullptr;
+		}
+
+		++hit_count;
+		entries.splice(entries.begin(), entries, it->second);
+		return &it->second->second;
+	}
+
+	// The entry for this key, or nullptr, without counting it or marking it used.
+	Value* peek(const Key& key)
+	{
+		const auto it = index.find(key);
+		return it == index.end() ? nullptr : &it->second->second;
+	}
+
+	// Add or replace the entry for this key, dropping the least recently used entry if the cache is full.
+	void insert(const Key& key, Value value)
+	{
+		if (capacity == 0) return;
+
+		if (const auto it = index.find(key); it != index.end())
+		{
+			it->second->second = std::move(value);
+			entries.splice(entries.begin(), entries, it->second);
+			return;
+		}
+
+		if (entries.size() == capacity)
+		{
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+
+		entries.emplace_front(key, std::move(value));
+		index.emplace(key, entries.begin());
+	}
+
+	void clear()
+	{
+		entries.clear();
+		index.clear();
+	}
+
+	size_t size() const { return entries.size(); }
+	size_t hits() const { return hit_count; }
+	size_t misses() const { return miss_count; }
+	double hit_rate() const { return hit_count + miss_count ? double(hit_count) / double(hit_count + miss_count) : 0.0; }
+
+private:
+	using entries_t = std::list<std::pair<Key, Value>>;
+
+	const size_t capacity;
+	entries_t entries; // most recently used first
+	std::unordered_map<Key, typename entries_t::iterator, Hash> index;
+
+	size_t hit_count = 0;
+	size_t miss_count = 0;
+};
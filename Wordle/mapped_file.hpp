@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// This process's id, to tell apart files and segments written by processes running at the same time.
+unsigned long current_process_id()
+{
+#ifdef _WIN32
+	return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+	return static_cast<unsigned long>(getpid());
+#endif
+}
+
+/*
+A read-only memory mapping of a whole file. The file's pages come straight from the OS page cache, so there is
+no copy into a buffer, and processes mapping the same file share the same physical pages.
+*/
+class Mapped_file
+{
+public:
+	explicit Mapped_file(const std::string& filename)
+	{
+#ifdef _WIN32
+		file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) return;
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) return;
+
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr) return;
+
+		begin = static_cast<const char*>(view);
+		length = size_t(file_size.QuadPart);
+#else
+		fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0) return;
+
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) return;
+
+		void* view = mmap(nullptr, size_t(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		if (view == MAP_FAILED) return;
+
+		begin = static_cast<const char*>(view);
+		length = size_t(file_stat.st_size);
+#endif
+	}
+
+	~Mapped_file()
+	{
+#ifdef _WIN32
+		if (begin != nullptr) UnmapViewOfFile(begin);
+		if (mapping != nullptr) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if (begin != nullptr) munmap(const_cast<char*>(begin), length);
+		if (fd >= 0) close(fd);
+#endif
+	}
+
+	Mapped_file(const Mapped_file&) = delete;
+	Mapped_file& operator=(const Mapped_file&) = delete;
+
+	bool is_open() const { return begin != nullptr; }
+
+	/*
+	Ask for the mapping to be backed by huge pages, which cuts TLB misses on large tables that are read at
+	random. It's only advice, and only Linux takes it (for file mappings, when the kernel supports it).
+	*/
+	void advise_hugepages() const
+	{
+#if defined(MADV_HUGEPAGE)
+		if (begin != nullptr) madvise(const_cast<char*>(begin), length, MADV_HUGEPAGE);
+#endif
+	}
+
+	const char* data() const { return begin; }
+	size_t size() const { return length; }
+
+private:
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+
+	const char* begin = nullptr;
+	size_t length = 0;
+};
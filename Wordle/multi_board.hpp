@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "utility.hpp"
+#include "wordle.hpp"
+
+/*
+Multi-board mode (Dordle, Quordle, Octordle, ...): N answers are solved at once. Every guess is played on
+every board that is still unsolved, and each board keeps its own list of candidates. A solved board's list
+is cleared.
+*/
+
+template<size_t length>
+using boards_t = std::vector<std::vector<word_t<length>>>;
+
+/*
+Find the guess with the most combined information: the sum, over every unsolved board, of the entropy of the
+board's pattern distribution. Each guess is scored against all boards in one pass over the guess list, and the
+guess list is split across the pool's threads.
+*/
+template<size_t length>
+word_t<length> select_multi_guess(const boards_t<length>& boards, const std::vector<word_t<length>>& dictionary, Thread_pool& pool)
+{
+	constexpr size_t patterns = detail::pattern_count(length);
+
+	struct best_guess
+	{
+		double score = -1.0;
+		size_t index = 0;
+	};
+
+	std::vector<best_guess> best(pool.size());
+
+	pool.parallel_for(dictionary.size(), [&](const size_t begin, const size_t end, const size_t thread)
+		{
+			std::vector<uint32_t> histogram(patterns);
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				double score = 0.0;
+
+				for (const auto& candidates : boards)
+				{
+					if (candidates.empty()) continue;
+
+					std::fill(histogram.begin(), histogram.end(), 0);
+					for (const auto& answer : candidates)
+						++histogram[get_pattern(dictionary[i], answer)];
+
+					score += pattern_entropy(histogram, candidates.size());
+
+					// the all-green bucket is non-empty if this guess could solve the board outright
+					score += double(histogram[patterns - 1]) / candidates.size();
+				}
+
+				if (score > best[thread].score)
+					best[thread] = { score, i };
+			}
+		});
+
+	const auto it = std::max_element(best.begin(), best.end(),
+		[](const best_guess& a, const best_guess& b) { return a.score < b.score; });
+
+	return dictionary[it->index];
+}
+
+/*
+Play one multi-board game, and return the number of guesses it took, or 0 if we ran out. The guess limit is
+the number of boards plus five, as in Dordle (7), Quordle (9) and Octordle (13).
+*/
+template<size_t length>
+size_t play_multi(const std::vector<word_t<length>>& dictionary, const std::vector<word_t<length>>& answers, Thread_pool& pool,
+	const word_t<length>& first_guess = "")
+{
+	const size_t max_guesses = answers.size() + 5;
+
+	boards_t<length> boards(answers.size(), dictionary);
+	size_t unsolved = answers.size();
+
+	for (size_t guess_n = 0; guess_n < max_guesses; ++guess_n)
+	{
+		const word_t<length> guess = (guess_n == 0 && !first_guess.empty()) ?
+			first_guess :
+			select_multi_guess(boards, dictionary, pool);
+
+		for (size_t i = 0; i < boards.size(); ++i)
+		{
+			if (boards[i].empty()) continue;
+
+			if (guess == answers[i])
+			{
+				boards[i].clear();
+				--unsolved;
+			}
+			else
+			{
+				filter_by_pattern(boards[i], guess, answers[i]);
+			}
+		}
+
+		if (unsolved == 0) return guess_n + 1;
+	}
+
+	std::cout << "Lost on";
+	for (const auto& answer : answers)
+		std::cout << ' ' << answer;
+	std::cout << ", " << unsolved << " boards unsolved.\n";
+
+	return 0;
+}
+
+template<size_t length>
+void test_multi(const std::vector<word_t<length>>& dictionary, const size_t board_count, const size_t games)
+{
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	const auto start_time = current_time_in_us();
+
+	// Every turn of every game scores the whole dictionary, so the threads are started once, for all of them.
+	Thread_pool pool;
+
+	// Every board starts with the full dictionary, so the first guess is the same for every game.
+	const word_t<length> first_guess = select_multi_guess(boards_t<length>(1, dictionary), dictionary, pool);
+
+	size_t wins = 0;
+	size_t total_guesses = 0;
+
+	for (size_t game = 0; game < games; ++game)
+	{
+		std::vector<word_t<length>> answers;
+		for (size_t i = 0; i < board_count; ++i)
+			answers.push_back(dictionary[random_int_from(0, dictionary.size() - 1)]);
+
+		const size_t guesses = play_multi(dictionary, answers, pool, first_guess);
+		if (guesses == 0) continue;
+
+		++wins;
+		total_guesses += guesses;
+	}
+
+	const auto elapsed_time = current_time_in_us() - start_time;
+
+	std::cout << "\nPlayed " << games << " games of " << board_count << " boards, won " << wins
+		<< " (" << (wins > 0 ? double(total_guesses) / wins : 0.0) << " guesses per win), "
+		<< elapsed_time / 1'000 << " ms elapsed (" << (elapsed_time / std::max<size_t>(1, games)) << " us per game)\n";
+}
+
+void test_multi(const size_t board_count, const size_t games)
+{
+	test_multi(load_wordle_nyt_words(), board_count, games);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "wordle.hpp"
+
+/*
+The GUI's board, with each row packed into one integer: 5 bits per letter (0 for a blank tile, otherwise the
+letter's index plus 1), then 2 bits per tile color, which is that tile's digit of the row's pattern. A 5-letter
+row takes 35 bits, and the whole board is a few words on the stack that copy, compare and hash without any
+pointer chasing.
+*/
+template<size_t row_count, size_t length>
+class Packed_board
+{
+public:
+	using row_t = uint64_t;
+
+	static constexpr size_t letter_bits = 5;
+	static constexpr size_t color_bits = 2;
+	static constexpr size_t color_shift = length * letter_bits;
+	static_assert(length * (letter_bits + color_bits) <= 64, "a row must fit in 64 bits");
+
+	// The letter on this tile, or ' ' if it's blank.
+	char letter(const size_t row, const size_t column) const
+	{
+		const uint32_t code = letter_code(row, column);
+		return code ? char(detail::letter_a + code - 1) : ' ';
+	}
+
+	bool is_blank(const size_t row, const size_t column) const { return letter_code(row, column) == 0; }
+
+	// The tile's color, as its pattern digit: 0 for grey, 1 for yellow, 2 for green.
+	uint32_t color(const size_t row, const size_t column) const
+	{
+		return uint32_t(packed[row] >> (color_shift + column * color_bits)) & color_mask;
+	}
+
+	// Put a letter on a tile, which turns it grey.
+	void set_letter(const size_t row, const size_t column, const char c)
+	{
+		clear_tile(row, column);
+		packed[row] |= row_t(c - detail::letter_a + 1) << (column * letter_bits);
+	}
+
+	void set_color(const size_t row, const size_t column, const uint32_t color)
+	{
+		const size_t shift = color_shift + column * color_bits;
+		packed[row] = (packed[row] & ~(row_t(color_mask) << shift)) | (row_t(color & color_mask) << shift);
+	}
+
+	void clear_tile(const size_t row, const size_t column)
+	{
+		packed[row] &= ~((row_t(letter_mask) << (column * letter_bits)) | (row_t(color_mask) << (color_shift + column * color_bits)));
+	}
+
+	void clear() { packed.fill(0); }
+
+	row_t row(const size_t r) const { return packed[r]; }
+
+	// How many tiles of the row have letters. Letters are typed left to right, so these are the first ones.
+	size_t letters_in_row(const size_t row) const
+	{
+		size_t n = 0;
+		for (size_t column = 0; column < length; ++column)
+			n += letter_code(row, column) != 0;
+		return n;
+	}
+
+	bool is_complete(const size_t row) const { return letters_in_row(row) == length; }
+
+	// The row's letters as a word. Only meaningful once the row is complete.
+	word_t<length> word(const size_t row) const
+	{
+		word_t<length> w;
+		for (size_t column = 0; column < length; ++column)
+			w.push_back(letter(row, column));
+		return w;
+	}
+
+	// The row's colors as a base-3 pattern, as get_pattern() gives them.
+	uint32_t pattern(const size_t row) const
+	{
+		uint32_t p = 0;
+		for (size_t column = length; column-- > 0;)
+			p = p * 3 + color(row, column);
+		return p;
+	}
+
+	/*
+	Every hint on the board, compiled into Constraints. Each row adds the letters typed so far with its pattern,
+	so repeated letters are graded as get_pattern() grades them.
+	*/
+	Constraints<length> constraints() const
+	{
+		Constraints<length> hints;
+		for (size_t row = 0; row < row_count; ++row)
+		{
+			const size_t letters = letters_in_row(row);
+			word_t<length> typed;
+			for (size_t column = 0; column < letters; ++column)
+				typed.push_back(letter(row, column));
+			hints.add_pattern(typed, pattern(row));
+		}
+		return hints;
+	}
+
+	bool operator==(const Packed_board& other) const { return packed == other.packed; }
+	bool operator!=(const Packed_board& other) const { return packed != other.packed; }
+
+	// A multiply-xorshift per row: a handful of instructions for the whole board.
+	size_t hash() const
+	{
+		uint64_t h = 0;
+		for (const row_t r : packed)
+		{
+			h = (h ^ r) * 0x9E3779B97F4A7C15ull;
+			h ^= h >> 32;
+		}
+		return size_t(h);
+	}
+
+	struct hasher
+	{
+		size_t operator()(const Packed_board& board) const { return board.hash(); }
+	};
+
+private:
+	static constexpr uint32_t letter_mask = (1u << letter_bits) - 1;
+	static constexpr uint32_t color_mask = (1u << color_bits) - 1;
+
+	uint32_t letter_code(const size_t row, const size_t column) const
+	{
+		return uint32_t(packed[row] >> (column * letter_bits)) & letter_mask;
+	}
+
+	std::array<row_t, row_count> packed{};
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "utility.hpp"
+#include "words.hpp"
+
+/*
+A kernel that computes the pattern of one guess against a block of answers, one pattern byte per answer. With
+AVX2 it handles 32 answers per iteration (16 with SSE2), and get_pattern() serves as the scalar reference.
+*/
+
+static_assert(detail::pattern_count(detail::word_length) <= 256, "patterns must fit in a byte");
+
+namespace detail
+{
+	constexpr size_t answer_block_padding = 32; // the widest vector we use
+}
+
+/*
+Answers in structure-of-arrays form: letters(i)[j] is letter i of answer j. Each column is padded with zeros
+to a whole number of vectors; zero never matches a letter, so padding lanes just produce junk patterns.
+*/
+class Answer_block
+{
+public:
+	explicit Answer_block(const std::vector<string_t>& answers) :
+		count{ answers.size() },
+		padded_count{ (answers.size() + detail::answer_block_padding - 1) / detail::answer_block_padding * detail::answer_block_padding }
+	{
+		for (size_t i = 0; i < detail::word_length; ++i)
+		{
+			columns[i].assign(padded_count, 0);
+			for (size_t j = 0; j < count; ++j)
+				columns[i][j] = uint8_t(answers[j][i]);
+		}
+	}
+
+	const uint8_t* letters(const size_t position) const { return columns[position].data(); }
+
+	size_t size() const { return count; }
+	size_t padded_size() const { return padded_count; } // how many bytes compute_patterns() writes
+
+private:
+	size_t count;
+	size_t padded_count;
+	std::array<std::vector<uint8_t>, detail::word_length> columns;
+};
+
+namespace detail
+{
+#if defined(__AVX2__)
+	struct simd_ops
+	{
+		using vec = __m256i;
+		static constexpr size_t width = 32;
+
+		static vec load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+		static void store(uint8_t* p, const vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+		static vec set1(const uint8_t x) { return _mm256_set1_epi8(char(x)); }
+		static vec zero() { return _mm256_setzero_si256(); }
+		static vec eq(const vec a, const vec b) { return _mm256_cmpeq_epi8(a, b); }
+		static vec gt(const vec a, const vec b) { return _mm256_cmpgt_epi8(a, b); }
+		static vec andnot(const vec a, const vec b) { return _mm256_andnot_si256(a, b); } // ~a & b
+		static vec and_(const vec a, const vec b) { return _mm256_and_si256(a, b); }
+		static vec or_(const vec a, const vec b) { return _mm256_or_si256(a, b); }
+		static vec add(const vec a, const vec b) { return _mm256_add_epi8(a, b); }
+		static vec sub(const vec a, const vec b) { return _mm256_sub_epi8(a, b); }
+	};
+#elif defined(__SSE2__) || defined(_M_X64)
+	struct simd_ops
+	{
+		using vec = __m128i;
+		static constexpr size_t width = 16;
+
+		static vec load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+		static void store(uint8_t* p, const vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+		static vec set1(const uint8_t x) { return _mm_set1_epi8(char(x)); }
+		static vec zero() { return _mm_setzero_si128(); }
+		static vec eq(const vec a, const vec b) { return _mm_cmpeq_epi8(a, b); }
+		static vec gt(const vec a, const vec b) { return _mm_cmpgt_epi8(a, b); }
+		static vec andnot(const vec a, const vec b) { return _mm_andnot_si128(a, b); } // ~a & b
+		static vec and_(const vec a, const vec b) { return _mm_and_si128(a, b); }
+		static vec or_(const vec a, const vec b) { return _mm_or_si128(a, b); }
+		static vec add(const vec a, const vec b) { return _mm_add_epi8(a, b); }
+		static vec sub(const vec a, const vec b) { return _mm_sub_epi8(a, b); }
+	};
+#endif
+}
+
+// The scalar reference: get_pattern() for every answer.
+void compute_patterns_scalar(const string_t& guess, const std::vector<string_t>& answers, uint8_t* const patterns)
+{
+	for (size_t i = 0; i < answers.size(); ++i)
+		patterns[i] = uint8_t(get_pattern(guess, answers[i]));
+}
+
+namespace detail
+{
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	/*
+	The vector loop. For a guess without repeated letters, a letter that isn't green is yellow if any other
+	position of the answer has it; the greens elsewhere can't be this letter, so they needn't be excluded. That
+	case is common enough to get its own instantiation without any of the duplicate bookkeeping.
+	*/
+	template<bool distinct_letters>
+	void compute_patterns(const string_t& guess, const Answer_block& answers, uint8_t* const patterns, const size_t begin, const size_t end)
+	{
+		using ops = simd_ops;
+		using vec = ops::vec;
+
+		// Everything that depends only on the guess is worked out once, outside the loop.
+		size_t first_use[word_length]; // the first position in the guess with the same letter
+		for (size_t i = 0; i < word_length; ++i)
+		{
+			first_use[i] = i;
+			for (size_t j = i; j-- > 0; )
+				if (guess[j] == guess[i])
+					first_use[i] = j;
+		}
+
+		vec letter[word_length];
+		for (size_t i = 0; i < word_length; ++i)
+			letter[i] = ops::set1(uint8_t(guess[i]));
+
+		const vec one = ops::set1(1);
+		const vec all_ones = ops::set1(0xFF);
+
+		for (size_t base = begin; base < end; base += ops::width)
+		{
+			vec answer[word_length], green[word_length];
+			for (size_t k = 0; k < word_length; ++k)
+			{
+				answer[k] = ops::load(answers.letters(k) + base);
+				green[k] = ops::eq(answer[k], letter[k]);
+			}
+
+			vec pattern = ops::zero();
+			vec available[word_length];
+			uint8_t place = 1;
+
+			for (size_t i = 0; i < word_length; ++i, place *= 3)
+			{
+				vec yellow;
+
+				if (distinct_letters)
+				{
+					vec elsewhere = ops::zero();
+					for (size_t k = 0; k < word_length; ++k)
+						if (k != i)
+							elsewhere = ops::or_(elsewhere, ops::eq(answer[k], letter[i]));
+
+					yellow = ops::andnot(green[i], elsewhere);
+				}
+				else
+				{
+					/*
+					How many copies of this letter the answer has outside its green positions. Each mask is -1 per
+					match, so subtracting counts up. A green can only be this letter where the guess has this
+					letter, so the greens come off without comparing again.
+					*/
+					if (first_use[i] == i)
+					{
+						available[i] = ops::zero();
+						for (size_t k = 0; k < word_length; ++k)
+							available[i] = ops::sub(available[i], ops::eq(answer[k], letter[i]));
+						for (size_t k = i; k < word_length; ++k)
+							if (guess[k] == guess[i])
+								available[i] = ops::add(available[i], green[k]);
+					}
+					else
+					{
+						available[i] = available[first_use[i]];
+					}
+
+					// this letter's rank among the non-green uses of it in the guess, so far
+					vec rank = ops::zero();
+					for (size_t j = first_use[i]; j <= i; ++j)
+						if (guess[j] == guess[i])
+							rank = ops::sub(rank, ops::andnot(green[j], all_ones));
+
+					yellow = ops::andnot(green[i], ops::gt(ops::add(available[i], one), rank));
+				}
+
+				pattern = ops::add(pattern, ops::add(
+					ops::and_(green[i], ops::set1(uint8_t(2 * place))),
+					ops::and_(yellow, ops::set1(place))));
+			}
+
+			ops::store(patterns + (base - begin), pattern);
+		}
+	}
+#endif
+}
+
+/*
+Write the pattern of guess against answers [begin, end) of the block to patterns. begin must be a multiple of
+detail::answer_block_padding; the range is rounded up to a whole number of vectors, so patterns must have room
+for that many bytes.
+
+Duplicate letters: with greens marked, letter i of the guess is yellow if it is the n-th non-green use of its
+letter in the guess (counting from the left), and the answer has at least n copies of that letter outside its
+green positions. This is exactly what get_pattern() does, but with no per-answer state, so each answer is a lane.
+*/
+void compute_patterns(const string_t& guess, const Answer_block& answers, uint8_t* const patterns, const size_t begin, size_t end)
+{
+	end = std::min(answers.padded_size(),
+		(end + detail::answer_block_padding - 1) / detail::answer_block_padding * detail::answer_block_padding);
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	bool distinct_letters = true;
+	for (size_t i = 0; i < detail::word_length; ++i)
+		for (size_t j = 0; j < i; ++j)
+			if (guess[i] == guess[j])
+				distinct_letters = false;
+
+	if (distinct_letters)
+		detail::compute_patterns<true>(guess, answers, patterns, begin, end);
+	else
+		detail::compute_patterns<false>(guess, answers, patterns, begin, end);
+#else
+	for (size_t i = begin; i < std::min(end, answers.size()); ++i)
+	{
+		string_t answer;
+		for (size_t k = 0; k < detail::word_length; ++k)
+			answer.push_back(char(answers.letters(k)[i]));
+		patterns[i - begin] = uint8_t(get_pattern(guess, answer));
+	}
+#endif
+}
+
+// Write the pattern of guess against every answer in the block to patterns, which must hold padded_size() bytes.
+void compute_patterns(const string_t& guess, const Answer_block& answers, uint8_t* const patterns)
+{
+	compute_patterns(guess, answers, patterns, 0, answers.padded_size());
+}
+
+// Return how many patterns the kernel gets wrong, checked against the scalar reference.
+size_t verify_pattern_kernel(const std::vector<string_t>& guesses, const std::vector<string_t>& answers)
+{
+	const Answer_block block{ answers };
+	std::vector<uint8_t> expected(answers.size()), actual(block.padded_size());
+
+	size_t mismatches = 0;
+	for (const auto& guess : guesses)
+	{
+		compute_patterns_scalar(guess, answers, expected.data());
+		compute_patterns(guess, block, actual.data());
+
+		for (size_t i = 0; i < answers.size(); ++i)
+			mismatches += expected[i] != actual[i];
+	}
+
+	return mismatches;
+}
+
+void test_pattern_kernel()
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	const Answer_block block{ dictionary };
+	std::vector<uint8_t> patterns(block.padded_size());
+	size_t checksum = 0;
+
+	auto start_time = current_time_in_us();
+	for (const auto& guess : dictionary)
+	{
+		compute_patterns(guess, block, patterns.data());
+		checksum += patterns[0];
+	}
+	const auto kernel_time = std::max<int64_t>(1, current_time_in_us() - start_time);
+
+	start_time = current_time_in_us();
+	for (const auto& guess : dictionary)
+	{
+		compute_patterns_scalar(guess, dictionary, patterns.data());
+		checksum += patterns[0];
+	}
+	const auto scalar_time = std::max<int64_t>(1, current_time_in_us() - start_time);
+
+	const double count = double(dictionary.size()) * dictionary.size();
+	std::cout << "Kernel: " << kernel_time / 1'000 << " ms (" << count / kernel_time / 1'000 << " billion patterns/s)\n"
+		<< "Scalar: " << scalar_time / 1'000 << " ms (" << count / scalar_time / 1'000 << " billion patterns/s)\n"
+		<< "Mismatches: " << verify_pattern_kernel(dictionary, dictionary) << " (checksum " << checksum << ")\n";
+}
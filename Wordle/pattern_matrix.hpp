@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "pattern_kernel.hpp"
+#include "utility.hpp"
+#include "wordle.hpp"
+
+/*
+The full guess-by-answer pattern matrix, one byte per pair, guess-major. For the NYT lists it is about 30 MB and
+takes a while to build, so it is cached on disk: one file per pair of word lists, named by a hash of both lists.
+Loading maps the file read-only, so every solver process on the host shares the page cache's copy of it.
+
+The file is a fixed header padded to one page, then the matrix. The header carries a format version and a
+checksum of the matrix; a file that doesn't match is rebuilt, and a new file is written under a temporary name
+and renamed into place, so a reader never sees it half-written.
+*/
+
+namespace detail
+{
+	constexpr uint64_t pattern_matrix_magic = 0x54414d5044524f57ull; // "WORDPMAT"
+	constexpr uint32_t pattern_matrix_version = 1; // bump whenever the layout or the pattern encoding changes
+	constexpr size_t pattern_matrix_data_offset = 4096; // the matrix starts on a page boundary
+
+	struct Pattern_matrix_header
+	{
+		uint64_t magic = pattern_matrix_magic;
+		uint32_t version = pattern_matrix_version;
+		uint32_t data_offset = uint32_t(pattern_matrix_data_offset);
+		uint64_t lists_hash = 0;
+		uint64_t guess_count = 0;
+		uint64_t answer_count = 0;
+		uint64_t checksum = 0;
+	};
+
+	static_assert(sizeof(Pattern_matrix_header) <= pattern_matrix_data_offset, "the header must fit before the matrix");
+
+	// FNV-1a over both lists, with their sizes, so the same words split differently hash differently.
+	uint64_t hash_word_lists(const std::vector<string_t>& guesses, const std::vector<string_t>& answers)
+	{
+		uint64_t h = 14695981039346656037ull;
+		const auto mix = [&h](const uint64_t x)
+		{
+			h ^= x;
+			h *= 1099511628211ull;
+		};
+
+		for (const auto* list : { &guesses, &answers })
+		{
+			mix(list->size());
+			for (const auto& word : *list)
+				for (size_t i = 0; i < word_length; ++i)
+					mix(uint8_t(word[i]));
+		}
+		return h;
+	}
+
+	// A checksum of the matrix, eight bytes at a time so checking a loaded file costs little next to mapping it.
+	uint64_t checksum(const uint8_t* data, const size_t size)
+	{
+		uint64_t h = 14695981039346656037ull;
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			h = (h ^ word) * 0x100000001b3ull;
+			h ^= h >> 29;
+		}
+		for (; i < size; ++i)
+			h = (h ^ data[i]) * 0x100000001b3ull;
+		return h;
+	}
+
+	std::filesystem::path pattern_cache_directory()
+	{
+		std::error_code error;
+		const auto temp = std::filesystem::temp_directory_path(error);
+		return error ? std::filesystem::path{ "." } : temp / "wordle";
+	}
+}
+
+// Fill matrix, which must hold guesses.size() * answers.size() bytes, with the pattern of every pair.
+void build_pattern_matrix(const std::vector<string_t>& guesses, const std::vector<string_t>& answers, uint8_t* const matrix)
+{
+	const Answer_block block{ answers };
+
+	parallel_for(guesses.size(), [&](const size_t begin, const size_t end, const size_t)
+		{
+			std::vector<uint8_t> row(block.padded_size());
+			for (size_t g = begin; g < end; ++g)
+			{
+				compute_patterns(guesses[g], block, row.data());
+				std::memcpy(matrix + g * answers.size(), row.data(), answers.size());
+			}
+		});
+}
+
+/*
+A read-only view of a pattern matrix. The memory is either a mapped cache file or a buffer built in this process;
+either way it is kept alive for as long as any copy of the view.
+*/
+class Pattern_matrix
+{
+public:
+	Pattern_matrix() = default;
+
+	Pattern_matrix(std::shared_ptr<const void> set_storage, const uint8_t* set_data, const size_t set_guess_count, const size_t set_answer_count) :
+		storage{ std::move(set_storage) },
+		matrix{ set_data },
+		guesses{ set_guess_count },
+		answers{ set_answer_count } {}
+
+	// The patterns of one guess against every answer.
+	const uint8_t* row(const size_t guess) const { return matrix + guess * answers; }
+
+	uint8_t pattern(const size_t guess, const size_t answer) const { return matrix[guess * answers + answer]; }
+
+	const uint8_t* data() const { return matrix; }
+	size_t guess_count() const { return guesses; }
+	size_t answer_count() const { return answers; }
+	size_t size() const { return guesses * answers; }
+	bool empty() const { return matrix == nullptr; }
+
+private:
+	std::shared_ptr<const void> storage;
+	const uint8_t* matrix = nullptr;
+	size_t guesses = 0;
+	size_t answers = 0;
+};
+
+// Build the matrix in memory, without touching the cache.
+Pattern_matrix make_pattern_matrix(const std::vector<string_t>& guesses, const std::vector<string_t>& answers)
+{
+	auto buffer = std::make_shared<std::vector<uint8_t>>(guesses.size() * answers.size());
+	build_pattern_matrix(guesses, answers, buffer->data());
+	const uint8_t* data = buffer->data();
+	return { std::move(buffer), data, guesses.size(), answers.size() };
+}
+
+namespace detail
+{
+	// Map a cache file and check it against the lists; return an empty matrix if it's missing, stale or corrupt.
+	Pattern_matrix map_pattern_matrix(const std::filesystem::path& filename, const uint64_t lists_hash, const size_t guess_count, const size_t answer_count)
+	{
+		auto file = std::make_shared<Mapped_file>(filename.string());
+		if (!file->is_open() || file->size() < pattern_matrix_data_offset) return {};
+
+		Pattern_matrix_header header;
+		std::memcpy(&header, file->data(), sizeof(header));
+
+		const size_t size = guess_count * answer_count;
+		if (header.magic != pattern_matrix_magic || header.version != pattern_matrix_version ||
+			header.data_offset != pattern_matrix_data_offset || header.lists_hash != lists_hash ||
+			header.guess_count != guess_count || header.answer_count != answer_count ||
+			file->size() != pattern_matrix_data_offset + size)
+			return {};
+
+		file->advise_hugepages();
+
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(file->data()) + pattern_matrix_data_offset;
+		if (checksum(data, size) != header.checksum) return {};
+
+		return { std::move(file), data, guess_count, answer_count };
+	}
+
+	/*
+	Write the file under a name of its own, then rename it over the real one, which readers only ever see whole.
+	The name has the process id in it, so processes building the same matrix at once never share a file.
+	*/
+	bool write_pattern_matrix(const std::filesystem::path& filename, const Pattern_matrix_header& header, const Pattern_matrix& matrix)
+	{
+		std::filesystem::path temp = filename;
+		temp += "." + std::to_string(current_process_id()) + "." + std::to_string(current_time_in_us()) + ".tmp";
+
+		{
+			std::ofstream out{ temp, std::ios::binary | std::ios::trunc };
+			if (!out) return false;
+
+			std::vector<char> page(pattern_matrix_data_offset, 0);
+			std::memcpy(page.data(), &header, sizeof(header));
+			out.write(page.data(), std::streamsize(page.size()));
+			out.write(reinterpret_cast<const char*>(matrix.data()), std::streamsize(matrix.size()));
+		}
+
+		std::error_code error;
+		if (std::filesystem::file_size(temp, error) == pattern_matrix_data_offset + matrix.size())
+		{
+			std::filesystem::rename(temp, filename, error);
+			if (!error) return true;
+		}
+
+		std::filesystem::remove(temp, error);
+		return false;
+	}
+}
+
+/*
+Load the pattern matrix for these lists from the cache directory, building and saving it first if there is no
+valid file for them. If the cache can't be written, the matrix built in memory is returned instead.
+*/
+Pattern_matrix load_pattern_matrix(const std::vector<string_t>& guesses, const std::vector<string_t>& answers,
+	const std::filesystem::path& directory = detail::pattern_cache_directory())
+{
+	using namespace detail;
+
+	const uint64_t lists_hash = hash_word_lists(guesses, answers);
+
+	char name[32];
+	snprintf(name, sizeof(name), "patterns_%016llx.bin", static_cast<unsigned long long>(lists_hash));
+	const std::filesystem::path filename = directory / name;
+
+	Pattern_matrix matrix = map_pattern_matrix(filename, lists_hash, guesses.size(), answers.size());
+	if (!matrix.empty()) return matrix;
+
+	matrix = make_pattern_matrix(guesses, answers);
+
+	Pattern_matrix_header header;
+	header.lists_hash = lists_hash;
+	header.guess_count = guesses.size();
+	header.answer_count = answers.size();
+	header.checksum = checksum(matrix.data(), matrix.size());
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error || !write_pattern_matrix(filename, header, matrix)) return matrix;
+
+	// Swap the private buffer for the shared mapping, so this process doesn't hold a second copy.
+	Pattern_matrix mapped = map_pattern_matrix(filename, lists_hash, guesses.size(), answers.size());
+	return mapped.empty() ? matrix : mapped;
+}
+
+void test_pattern_matrix()
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	auto start_time = current_time_in_us();
+	const Pattern_matrix built = make_pattern_matrix(dictionary, dictionary);
+	const auto build_time = current_time_in_us() - start_time;
+
+	start_time = current_time_in_us();
+	const Pattern_matrix first = load_pattern_matrix(dictionary, dictionary);
+	const auto first_time = current_time_in_us() - start_time;
+
+	start_time = current_time_in_us();
+	const Pattern_matrix cached = load_pattern_matrix(dictionary, dictionary);
+	const auto cached_time = current_time_in_us() - start_time;
+
+	const bool same = cached.size() == built.size() && std::memcmp(cached.data(), built.data(), built.size()) == 0;
+
+	std::cout << "Matrix: " << built.size() / 1'000'000 << " MB\n"
+		<< "Build: " << build_time / 1'000 << " ms\n"
+		<< "First load: " << first_time / 1'000 << " ms\n"
+		<< "Cached load: " << cached_time / 1'000 << " ms\n"
+		<< "Matches the built matrix: " << (same ? "yes" : "no") << '\n';
+}
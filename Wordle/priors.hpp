@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "corpus_loader.hpp"
+#include "wordle.hpp"
+
+/*
+Priors for when the answer list is unknown: every word in the dictionary is a candidate, weighted by how likely
+it is to be the answer, judging by how common it is in the Norvig counts.
+*/
+
+namespace detail
+{
+	// Ranks are 0-based, most frequent first. The prior is 0.5 at the midpoint rank.
+	constexpr double prior_midpoint = 3000.0;
+	constexpr double prior_width = 500.0;
+}
+
+/*
+Return one prior per word, aligned with words: a sigmoid over the word's frequency rank, so common words are
+close to 1, and words well past the midpoint fade towards 0. Words missing from the counts rank last.
+*/
+template<size_t length>
+std::vector<float> make_priors(const std::vector<word_t<length>>& words, const Word_frequencies<length>& frequencies,
+	const double midpoint = detail::prior_midpoint, const double width = detail::prior_width)
+{
+	std::vector<size_t> counts = frequencies.counts;
+	std::sort(counts.begin(), counts.end(), std::greater<size_t>());
+
+	std::vector<float> priors;
+	priors.reserve(words.size());
+
+	for (const auto& word : words)
+	{
+		const size_t index = frequencies.words.index_of(word);
+		const size_t rank = (index == Word_set<length>::npos) ?
+			counts.size() :
+			size_t(std::lower_bound(counts.begin(), counts.end(), frequencies.counts[index], std::greater<size_t>()) - counts.begin());
+
+		priors.push_back(float(1.0 / (1.0 + std::exp((double(rank) - midpoint) / width))));
+	}
+
+	return priors;
+}
+
+/*
+Run the benchmark with every NYT word as a candidate, weighted by its Norvig frequency, picking guesses by the
+weighted letter scores of select_guess(), or with entropy, by select_guess_entropy().
+*/
+void test_with_priors(const bool hard_mode = false, const bool entropy = false, const bool parallel = false)
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	test(dictionary, hard_mode, make_priors(dictionary, load_norvig_words_with_frequencies()), entropy, parallel);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "text_rows.hpp"
+
+/*
+A titled list that can be scrolled through, however long it is. Only the rows in view are ever formatted and laid
+out: the list holds a count and a function that turns an index into a line, not the lines themselves, so a
+frame costs the same for 3 entries as for 12,972, and scrolling relays out one screenful.
+*/
+class Scroll_list
+{
+public:
+	using item_t = std::function<std::string(size_t)>;
+
+	Scroll_list(const Glyph_cache& set_glyphs, const sf::Vector2f set_position, const size_t set_visible_rows, const size_t columns,
+		const sf::Color set_color = sf::Color::White) :
+		glyphs{ set_glyphs },
+		position{ set_position },
+		visible_rows{ set_visible_rows },
+		color{ set_color },
+		text{ set_glyphs, set_position, set_visible_rows + first_item_row, columns, set_color } {}
+
+	void set_title(const std::string& title) { text.set_row(0, title); }
+
+	// Show a new list, from the top.
+	void set_items(const size_t count, item_t set_item)
+	{
+		item_count = count;
+		item = std::move(set_item);
+		top = 0;
+		layout();
+	}
+
+	// Scroll by this many rows, up if negative. Returns whether anything moved.
+	bool scroll(const ptrdiff_t rows)
+	{
+		const size_t last_top = item_count > visible_rows ? item_count - visible_rows : 0;
+		const size_t new_top = size_t(std::clamp<ptrdiff_t>(ptrdiff_t(top) + rows, 0, ptrdiff_t(last_top)));
+		if (new_top == top) return false;
+
+		top = new_top;
+		layout();
+		return true;
+	}
+
+	bool page_down() { return scroll(ptrdiff_t(visible_rows)); }
+	bool page_up() { return scroll(-ptrdiff_t(visible_rows)); }
+
+	void draw(sf::RenderTarget& target) const
+	{
+		text.draw(target);
+		target.draw(scrollbar);
+	}
+
+private:
+	static constexpr size_t first_item_row = 2; // below the title and a blank line
+	static constexpr float scrollbar_width = 4.f;
+
+	void layout()
+	{
+		for (size_t i = 0; i < visible_rows; ++i)
+			text.set_row(first_item_row + i, top + i < item_count ? item(top + i) : std::string{});
+
+		// The scrollbar's thumb is to the list what the rows in view are to all of it. A list that fits has none.
+		if (item_count <= visible_rows)
+		{
+			scrollbar.clear();
+			return;
+		}
+
+		const float spacing = glyphs.line_spacing();
+		const float track_top = position.y + first_item_row * spacing, track_height = visible_rows * spacing;
+		const float thumb_top = track_top + track_height * top / item_count;
+		const float thumb_height = std::max(track_height * visible_rows / item_count, scrollbar_width);
+		const float x = position.x - 4 * scrollbar_width;
+
+		scrollbar.resize(4);
+		scrollbar[0] = sf::Vertex{ { x, thumb_top }, color };
+		scrollbar[1] = sf::Vertex{ { x + scrollbar_width, thumb_top }, color };
+		scrollbar[2] = sf::Vertex{ { x + scrollbar_width, thumb_top + thumb_height }, color };
+		scrollbar[3] = sf::Vertex{ { x, thumb_top + thumb_height }, color };
+	}
+
+	const Glyph_cache& glyphs;
+	const sf::Vector2f position;
+	const size_t visible_rows;
+	const sf::Color color;
+
+	Text_rows text;
+	sf::VertexArray scrollbar{ sf::Quads };
+
+	size_t item_count = 0;
+	item_t item;
+	size_t top = 0; // index of the first item in view
+};
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "pattern_matrix.hpp"
+#include "wordle.hpp"
+
+/*
+The read-only tables every solver process needs: the answer list, the guess list, and the pattern matrix of
+one against the other. With sharing on, they live in one POSIX shared memory segment, named by a hash of the
+lists. The first process to ask creates and fills it; the others map the same pages and wait until it's ready,
+so memory use doesn't grow with the number of processes. The matrix is copied from the disk cache of
+load_pattern_matrix(), so it is only computed when no process on the host has computed it before.
+
+If the process filling the segment dies first, the segment would never be ready. A process waiting on it
+checks whether its creator is still alive, and if not, or if it waits too long, takes the stale segment down
+and builds a new one.
+
+Everything in the segment is found by offset from its start, with no pointers, so it means the same thing
+wherever each process maps it. The segment outlives the processes, like the disk cache; remove_shared_tables()
+takes it down. Without sharing, or where POSIX shared memory isn't available, the same layout is built in
+private memory.
+*/
+
+namespace detail
+{
+	constexpr uint64_t shared_tables_magic = 0x534c424154445257ull; // "WRDTABLS"
+	constexpr uint32_t shared_tables_version = 2;
+	constexpr size_t shared_tables_alignment = 64;
+	constexpr auto shared_tables_timeout = std::chrono::seconds(60); // how long to wait for another process to fill it
+	constexpr auto shared_tables_poll = std::chrono::milliseconds(1);
+
+	// Where everything is, as offsets from the start of the segment.
+	struct Shared_tables_layout
+	{
+		uint64_t lists_hash = 0;
+		uint64_t total_size = 0;
+		uint64_t answer_offset = 0, answer_count = 0; // word_length letters per word, no terminators
+		uint64_t word_offset = 0, word_count = 0;
+		uint64_t matrix_offset = 0; // word_count rows of answer_count patterns
+	};
+
+	struct Shared_tables_header
+	{
+		std::atomic<uint32_t> ready{ 0 }; // set last, once everything else is written
+		uint32_t version = shared_tables_version;
+		uint64_t magic = shared_tables_magic;
+		std::atomic<uint64_t> creator{ 0 }; // the id of the process filling it, written first
+		Shared_tables_layout layout;
+	};
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+		"the ready flag and creator must work across processes");
+
+	constexpr uint64_t align_up(const uint64_t x) { return (x + shared_tables_alignment - 1) / shared_tables_alignment * shared_tables_alignment; }
+
+	Shared_tables_layout layout_shared_tables(const std::vector<string_t>& answers, const std::vector<string_t>& words)
+	{
+		Shared_tables_layout layout;
+		layout.lists_hash = hash_word_lists(words, answers);
+		layout.answer_offset = align_up(sizeof(Shared_tables_header));
+		layout.answer_count = answers.size();
+		layout.word_offset = align_up(layout.answer_offset + answers.size() * word_length);
+		layout.word_count = words.size();
+		layout.matrix_offset = align_up(layout.word_offset + words.size() * word_length);
+		layout.total_size = layout.matrix_offset + uint64_t(words.size()) * answers.size();
+		return layout;
+	}
+
+	std::string shared_tables_name(const uint64_t lists_hash)
+	{
+		char name[40];
+		snprintf(name, sizeof(name), "/wordle_tables_%016llx", static_cast<unsigned long long>(lists_hash));
+		return name;
+	}
+
+	// A mapped region, unmapped when the last view of it goes away.
+	class Shared_region
+	{
+	public:
+		// A private region in ordinary memory.
+		explicit Shared_region(const size_t size) : buffer(size) { base = buffer.data(); length = size; }
+
+#ifndef _WIN32
+		Shared_region(char* const view, const size_t size) : base{ view }, length{ size }, mapped{ true } {}
+#endif
+
+		~Shared_region()
+		{
+#ifndef _WIN32
+			if (mapped) munmap(base, length);
+#endif
+		}
+
+		Shared_region(const Shared_region&) = delete;
+		Shared_region& operator=(const Shared_region&) = delete;
+
+		char* data() const { return base; }
+		bool is_shared() const { return mapped; }
+
+	private:
+		std::vector<char> buffer;
+		char* base = nullptr;
+		size_t length = 0;
+		bool mapped = false;
+	};
+
+	void fill_shared_tables(char* const base, const Shared_tables_layout& layout, const std::vector<string_t>& answers, const std::vector<string_t>& words)
+	{
+		auto* header = new (base) Shared_tables_header;
+		header->creator.store(current_process_id(), std::memory_order_relaxed);
+
+		for (size_t i = 0; i < answers.size(); ++i)
+			std::memcpy(base + layout.answer_offset + i * word_length, answers[i].data(), word_length);
+		for (size_t i = 0; i < words.size(); ++i)
+			std::memcpy(base + layout.word_offset + i * word_length, words[i].data(), word_length);
+
+		const Pattern_matrix matrix = load_pattern_matrix(words, answers);
+		std::memcpy(base + layout.matrix_offset, matrix.data(), matrix.size());
+
+		header->layout = layout;
+		header->ready.store(1, std::memory_order_release);
+	}
+
+#ifndef _WIN32
+	// Whether the process with this id has exited. A process we may not signal is still alive.
+	bool process_exited(const uint64_t id)
+	{
+		return id != 0 && kill(pid_t(id), 0) != 0 && errno == ESRCH;
+	}
+
+	/*
+	Take down the segment by this name, if it is still the one open as fd. If another process already replaced
+	it with a new one, that one is left alone.
+	*/
+	void unlink_stale_segment(const std::string& name, const int fd)
+	{
+		struct stat stale, current;
+		const int current_fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (current_fd < 0) return;
+
+		if (fstat(fd, &stale) == 0 && fstat(current_fd, &current) == 0 && stale.st_ino == current.st_ino)
+			shm_unlink(name.c_str());
+		close(current_fd);
+	}
+
+	/*
+	Create and fill the segment, or attach to the one another process made. Null if neither works. A segment
+	whose creator died, or that isn't ready in time, is replaced by a new one, once.
+	*/
+	std::shared_ptr<Shared_region> open_shared_region(const Shared_tables_layout& layout, const std::vector<string_t>& answers,
+		const std::vector<string_t>& words, const bool replace_stale = true)
+	{
+		const std::string name = shared_tables_name(layout.lists_hash);
+		const size_t size = size_t(layout.total_size);
+
+		int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (fd >= 0)
+		{
+			if (ftruncate(fd, off_t(size)) != 0)
+			{
+				close(fd);
+				shm_unlink(name.c_str());
+				return nullptr;
+			}
+
+			void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if (view == MAP_FAILED)
+			{
+				shm_unlink(name.c_str());
+				return nullptr;
+			}
+
+			fill_shared_tables(static_cast<char*>(view), layout, answers, words);
+			mprotect(view, size, PROT_READ);
+			return std::make_shared<Shared_region>(static_cast<char*>(view), size);
+		}
+
+		fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0) return nullptr;
+
+		// Give up on the segment: take it down, and try once more to make a new one.
+		const auto replace = [&]() -> std::shared_ptr<Shared_region>
+		{
+			if (replace_stale) unlink_stale_segment(name, fd);
+			close(fd);
+			return replace_stale ? open_shared_region(layout, answers, words, false) : nullptr;
+		};
+
+		// The creator may not have sized it yet.
+		const auto deadline = std::chrono::steady_clock::now() + shared_tables_timeout;
+		struct stat segment {};
+		while (fstat(fd, &segment) == 0 && size_t(segment.st_size) < size && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::sleep_for(shared_tables_poll);
+
+		if (size_t(segment.st_size) < size) return replace();
+		if (size_t(segment.st_size) != size)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		auto region = std::make_shared<Shared_region>(static_cast<char*>(view), size);
+		const auto* header = reinterpret_cast<const Shared_tables_header*>(region->data());
+
+		while (header->ready.load(std::memory_order_acquire) == 0)
+		{
+			if (process_exited(header->creator.load(std::memory_order_relaxed)) || std::chrono::steady_clock::now() >= deadline)
+				return replace();
+			std::this_thread::sleep_for(shared_tables_poll);
+		}
+
+		// A segment left by an older build, or for other lists with the same hash, is stale too.
+		if (header->magic != shared_tables_magic || header->version != shared_tables_version ||
+			header->layout.lists_hash != layout.lists_hash || header->layout.total_size != layout.total_size ||
+			header->layout.answer_count != layout.answer_count || header->layout.word_count != layout.word_count)
+			return replace();
+
+		close(fd);
+		return region;
+	}
+#endif
+}
+
+class Shared_tables
+{
+public:
+	/*
+	Build the tables for these lists in this process's own memory. With share, publish them instead, or attach to
+	the copy another process already published; if the segment can't be used, they are built privately after all.
+	*/
+	Shared_tables(const std::vector<string_t>& answers, const std::vector<string_t>& words, const bool share = false)
+	{
+		using namespace detail;
+
+		const Shared_tables_layout wanted = layout_shared_tables(answers, words);
+
+#ifndef _WIN32
+		if (share) region = open_shared_region(wanted, answers, words);
+#else
+		(void)share;
+#endif
+
+		if (region == nullptr)
+		{
+			region = std::make_shared<Shared_region>(size_t(wanted.total_size));
+			fill_shared_tables(region->data(), wanted, answers, words);
+		}
+
+		layout = &reinterpret_cast<const Shared_tables_header*>(region->data())->layout;
+	}
+
+	size_t answer_count() const { return size_t(layout->answer_count); }
+	size_t word_count() const { return size_t(layout->word_count); }
+
+	string_t answer(const size_t i) const { return string_t(region->data() + layout->answer_offset + i * detail::word_length, detail::word_length); }
+	string_t word(const size_t i) const { return string_t(region->data() + layout->word_offset + i * detail::word_length, detail::word_length); }
+
+	std::vector<string_t> answers() const
+	{
+		std::vector<string_t> list(answer_count());
+		for (size_t i = 0; i < list.size(); ++i) list[i] = answer(i);
+		return list;
+	}
+
+	std::vector<string_t> words() const
+	{
+		std::vector<string_t> list(word_count());
+		for (size_t i = 0; i < list.size(); ++i) list[i] = word(i);
+		return list;
+	}
+
+	// The pattern of word i against answer j, viewing the segment directly.
+	Pattern_matrix patterns() const
+	{
+		return { region, reinterpret_cast<const uint8_t*>(region->data() + layout->matrix_offset), word_count(), answer_count() };
+	}
+
+	bool is_shared() const { return region->is_shared(); }
+
+private:
+	std::shared_ptr<detail::Shared_region> region;
+	const detail::Shared_tables_layout* layout = nullptr;
+};
+
+// Take down the segment for these lists. Processes already attached keep their mapping.
+void remove_shared_tables(const std::vector<string_t>& answers, const std::vector<string_t>& words)
+{
+#ifndef _WIN32
+	shm_unlink(detail::shared_tables_name(detail::hash_word_lists(words, answers)).c_str());
+#else
+	(void)answers;
+	(void)words;
+#endif
+}
+
+void test_shared_tables()
+{
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+
+	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+
+	remove_shared_tables(dictionary, dictionary);
+
+	auto start_time = current_time_in_us();
+	const Shared_tables first{ dictionary, dictionary, true };
+	const auto create_time = current_time_in_us() - start_time;
+
+	start_time = current_time_in_us();
+	const Shared_tables second{ dictionary, dictionary, true };
+	const auto attach_time = current_time_in_us() - start_time;
+
+	const Pattern_matrix a = first.patterns(), b = second.patterns();
+	const bool same = first.words() == dictionary && second.answers() == dictionary &&
+		std::memcmp(a.data(), b.data(), a.size()) == 0 && a.pattern(1, 2) == get_pattern(dictionary[1], dictionary[2]);
+
+	std::cout << "Shared: " << (first.is_shared() && second.is_shared() ? "yes" : "no") << '\n'
+		<< "Create: " << create_time / 1'000 << " ms\n"
+		<< "Attach: " << attach_time / 1'000 << " ms\n"
+		<< "Tables agree: " << (same ? "yes" : "no") << '\n';
+
+	remove_shared_tables(dictionary, dictionary);
+}
@@ -5,8 +5,18 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
 
-#include <sstream>
-
+#include <filesystem>
+
+#include "background_worker.hpp"
+#include "candidate_index.hpp"
+#include "histogram_engine.hpp"
+#include "latency.hpp"
+#include "lru_cache.hpp"
+#include "packed_board.hpp"
+#include "scroll_list.hpp"
+#include "speculator.hpp"
+#include "thread_pool.hpp"
+#include "word_set.hpp"
 #include "wordle.hpp"
 
 namespace detail
@@ -18,6 +28,18 @@ namespace detail
 
 	constexpr size_t tile_size_px = 70;
 	constexpr size_t tile_padding_px = 7;
+	constexpr uint32_t letter_size_px = 70;
+
+	constexpr uint32_t candidates_size_px = 25; // the candidate list, on the left
+	constexpr uint32_t suggestions_size_px = 35; // the suggested guesses, on the right
+	constexpr size_t candidate_rows = 24; // how many words of each list are in view at once
+	constexpr size_t suggestion_rows = 17;
+	constexpr size_t list_columns = 16;
+	constexpr ptrdiff_t wheel_rows = 3; // rows scrolled per notch of the mouse wheel
+	constexpr uint32_t latency_size_px = 16; // the latency overlay, under the board
+	constexpr size_t latency_columns = 24;
+
+	constexpr size_t solutions_cache_size = 320; // boards whose candidates and guesses are kept: every pattern of a row, and then some
 
 	constexpr size_t board_x =
 		window_width / 2 -
@@ -25,54 +47,59 @@ namespace detail
 	constexpr size_t board_y =
 		window_height / 2 -
 		(rows * tile_size_px + (rows - 1) * tile_padding_px) / 2;
+	constexpr size_t board_bottom = board_y + rows * tile_size_px + (rows - 1) * tile_padding_px;
 
 	const sf::Color background = sf::Color::Black;
 	const sf::Color grey = { 54, 54, 54 }; // grey (ripped from ye internet)
 	const sf::Color yellow = { 250, 166, 19 }; // yellow (ripped from ye internet)
 	const sf::Color green = { 104, 142, 38 }; // green (ripped from ye internet)
-
-	enum class tile_color { grey, yellow, green };
+	const sf::Color invalid_word = { 230, 70, 70 }; // letters of a row that isn't in the word list
+	const sf::Color hover_outline = { 200, 200, 200 };
+
+	constexpr float hover_outline_px = 3.f;
+	constexpr int32_t scorer_poll_ms = 10; // how often to check on the scorer, while it's busy
+
+	// Fonts to try, in order. A build can put its own first by defining WORDLE_FONT.
+	const char* const font_paths[] = {
+#ifdef WORDLE_FONT
+		WORDLE_FONT,
+#endif
+		"C:/Windows/Fonts/Arial.ttf",
+		"/usr/share/fonts/truetype/msttcorefonts/Arial.ttf",
+		"/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+		"/usr/share/fonts/liberation-sans/LiberationSans-Regular.ttf",
+		"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+		"/usr/share/fonts/TTF/DejaVuSans.ttf",
+		"/Library/Fonts/Arial.ttf",
+		"/System/Library/Fonts/Supplemental/Arial.ttf",
+	};
+
+	const sf::Color tile_colors[] = { grey, yellow, green }; // by pattern digit, which is how the board stores colors
 }
 
+using Board = Packed_board<detail::rows, detail::word_length>;
 
-class Tile
+// What the solver works out for a board, kept for when the board comes back.
+struct Solutions
 {
-public:
-	explicit Tile() { reset(); }
-
-	bool is_blank() const { return c == ' '; }
-
-	void reset()
-	{
-		c = ' ';
-		tile_color = detail::tile_color::grey;
-	}
-
-	char c;
-	detail::tile_color tile_color;
-};
-
-class Guess
-{
-public:
-	explicit Guess(const size_t length) : guess(length, Tile()) {}
-	std::vector<Tile> guess;
-};
-
-class Board
-{
-public:
-	explicit Board(const size_t guesses, const size_t length) : board(guesses, Guess(length)) {}
-	std::vector<Guess> board;
+	std::vector<string_t> candidates;
+	ranked_guesses_t guesses;
+	bool scored = false; // whether guesses is filled in yet
 };
 
 class Solver
 {
 public:
-	Solver(const std::vector<string_t>& set_answer_list, const std::vector<string_t>& set_word_list) :
-		board{ detail::rows, detail::word_length },
+	Solver(const std::vector<string_t>& set_answer_list, const std::vector<string_t>& set_word_list,
+		const size_t cache_size = detail::solutions_cache_size) :
+		candidate_list{ candidate_glyphs, { 100.f, float(detail::board_y / 2) }, detail::candidate_rows, detail::list_columns },
+		guess_list{ suggestion_glyphs, { float(detail::window_width - 450), float(detail::board_y / 2) }, detail::suggestion_rows, detail::list_columns },
+		latency_overlay{ latency_glyphs, { float(detail::board_x), float(detail::board_bottom + 30) }, Latency_tracker::stage_count + 2, detail::latency_columns },
 		answer_list{ set_answer_list },
-		word_list{ set_word_list }
+		word_list{ set_word_list },
+		candidate_index{ answer_list },
+		legal_words{ word_list },
+		solutions_cache{ cache_size }
 	{
 		sf::ContextSettings settings;
 		settings.antialiasingLevel = 8;
@@ -85,39 +112,56 @@ public:
 
 		window->setFramerateLimit(60);
 
-		const std::string ARIAL_LOCATION = "C:/Windows/Fonts/Arial.ttf";
-		if (!arial.loadFromFile(ARIAL_LOCATION))
+		if (!load_font())
 		{
-			std::cout << "Could not load " << ARIAL_LOCATION << '\n';
+			std::cout << "Could not load a font. Tried:\n";
+			for (const char* path : detail::font_paths)
+				std::cout << "  " << path << '\n';
 			abort();
 		}
 
-		overlay.setFont(arial);
-		overlay.setCharacterSize(25);
-		overlay.setFillColor(sf::Color::White);
-		overlay.setPosition({ 100, float(detail::board_y / 2) });
+		letter_glyphs.load(font, detail::letter_size_px);
+		candidate_glyphs.load(font, detail::candidates_size_px);
+		suggestion_glyphs.load(font, detail::suggestions_size_px);
+		latency_glyphs.load(font, detail::latency_size_px);
 
-		overlay_right.setFont(arial);
-		overlay_right.setCharacterSize(35);
-		overlay_right.setFillColor(sf::Color::White);
-		overlay_right.setPosition({ float(detail::window_width - 450), float(detail::board_y / 2) });
+		update_solutions();
+	}
+
+public:
+	// Load the first of the fonts that exists. Only existing files are tried, so SFML doesn't complain about the rest.
+	bool load_font()
+	{
+		for (const char* path : detail::font_paths)
+		{
+			std::error_code error;
+			if (std::filesystem::exists(path, error) && font.loadFromFile(path))
+				return true;
+		}
+		return false;
+	}
 
-		letter.setFont(arial);
-		letter.setCharacterSize(70);
-		letter.setFillColor(sf::Color::White);
+	// Log how long each input event took, stage by stage, to this file.
+	bool log_latency(const std::string& filename = detail::latency_filename) { return latency.open_log(filename); }
 
+	// Everything that has to happen after the board changes.
+	void on_board_changed()
+	{
+		board_dirty = true;
 		update_solutions();
 	}
 
-public:
 	void on_click()
 	{
 		using namespace detail;
 
-		if (mouse_x > board_x &&
-			mouse_y > board_y &&
-			mouse_x <= board_x + word_length * tile_size_px + (word_length - 1) * tile_padding_px &&
-			mouse_y <= board_y + rows * tile_size_px + (rows - 1) * tile_padding_px)
+		// the mouse can be left of or above the window, where its coordinates are negative
+		const size_t x = size_t(std::max(mouse_x, 0)), y = size_t(std::max(mouse_y, 0));
+
+		if (x > board_x &&
+			y > board_y &&
+			x <= board_x + word_length * tile_size_px + (word_length - 1) * tile_padding_px &&
+			y <= board_y + rows * tile_size_px + (rows - 1) * tile_padding_px)
 		{
 			if (mouse_tile_x > word_length - 1 || mouse_tile_y > rows - 1)
 			{
@@ -125,86 +169,67 @@ public:
 				return;
 			}
 
-			if (board.board[mouse_tile_y].guess[mouse_tile_x].is_blank()) return;
-
-			tile_color& tile_color = board.board[mouse_tile_y].guess[mouse_tile_x].tile_color;
-
-			switch (tile_color)
-			{
-			case tile_color::grey:
-				tile_color = tile_color::yellow;
-				break;
-
-			case tile_color::yellow:
-				tile_color = tile_color::green;
-				break;
+			if (board.is_blank(mouse_tile_y, mouse_tile_x)) return;
 
-			case tile_color::green:
-				// deliberate fallthrough
+			// grey, then yellow, then green, then back to grey; the digits 0, 1 and 2
+			board.set_color(mouse_tile_y, mouse_tile_x, (board.color(mouse_tile_y, mouse_tile_x) + 1) % 3);
 
-			default:
-				tile_color = tile_color::grey;
-				break;
-			}
-
-			update_solutions();
+			on_board_changed();
 		}
 	}
 	void on_backspace_pressed()
 	{
 		using namespace detail;
 
-		if (board.board[0].guess[0].is_blank()) return;
+		if (board.is_blank(0, 0)) return;
+
+		speculator.cancel();
 
 		// search for the first empty tile
 		for (size_t i = 0; i < rows; ++i)
 		{
-			for (size_t j = 0; j < word_length; ++j)
+			const size_t j = board.letters_in_row(i);
+			if (j == word_length) continue;
+
+			// Erase the previous letter in this word, if one exists...
+			if (j > 0)
 			{
-				if (board.board[i].guess[j].is_blank())
-				{
-					// Erase the previous letter in this word, if one exists...
-					if (j > 0)
-					{
-						board.board[i].guess[j - 1].reset();
-					}
-					else // ...otherwise, erase the last letter of the previous word
-					{
-						board.board[i - 1].guess[word_length - 1].reset();
-					}
-
-					update_solutions();
-					return;
-				}
+				board.clear_tile(i, j - 1);
+			}
+			else // ...otherwise, erase the last letter of the previous word
+			{
+				board.clear_tile(i - 1, word_length - 1);
 			}
+
+			on_board_changed();
+			return;
 		}
 
 		// Special case; the board is full. Erase the last letter.
-		board.board[rows - 1].guess[word_length - 1].reset();
+		board.clear_tile(rows - 1, word_length - 1);
 
-		update_solutions();
+		on_board_changed();
 	}
 	void on_ctrl_c()
 	{
-		for (Guess& guess : board.board)
-			for (Tile& tile : guess.guess)
-				tile.reset();
-		update_solutions();
+		speculator.cancel();
+		board.clear();
+		on_board_changed();
 	}
 	void on_letter_pressed(const sf::Keyboard::Key key)
 	{
 		// When the user types a letter, search for the first empty tile
-		for (Guess& guess : board.board)
+		for (size_t i = 0; i < detail::rows; ++i)
 		{
-			for (Tile& t : guess.guess)
-			{
-				if (t.is_blank())
-				{
-					t.c = key - sf::Keyboard::Key::A + (int)'A';
-					update_solutions();
-					return;
-				}
-			}
+			const size_t j = board.letters_in_row(i);
+			if (j == detail::word_length) continue;
+
+			board.set_letter(i, j, char(key - sf::Keyboard::Key::A + (int)'A'));
+			on_board_changed();
+
+			if (j == detail::word_length - 1)
+				speculate(i);
+			return;
 		}
 	}
 	void on_key_pressed(const sf::Event::KeyEvent key)
@@ -223,14 +248,45 @@ public:
 		{
 			on_letter_pressed(key.code);
 		}
+		else if (key.code == sf::Keyboard::PageDown)
+		{
+			if (list_under_mouse().page_down()) redraw = true;
+		}
+		else if (key.code == sf::Keyboard::PageUp)
+		{
+			if (list_under_mouse().page_up()) redraw = true;
+		}
+	}
+
+	// The list on the mouse's side of the window.
+	Scroll_list& list_under_mouse()
+	{
+		return mouse_x < int32_t(detail::window_width / 2) ? candidate_list : guess_list;
 	}
 
+	/*
+	Wait for events and handle them. While the scorer is busy, wait only briefly, so its results are shown soon
+	after they arrive; otherwise, sleep until something happens.
+	*/
 	void handle_events()
 	{
 		using namespace detail;
 
 		sf::Event event;
-		while (window->pollEvent(event))
+		if (scorer.busy())
+		{
+			if (!window->pollEvent(event))
+			{
+				sf::sleep(sf::milliseconds(scorer_poll_ms));
+				return;
+			}
+		}
+		else if (!window->waitEvent(event))
+		{
+			return;
+		}
+
+		do
 		{
 			switch (event.type)
 			{
@@ -239,130 +295,229 @@ public:
 				mouse_y = event.mouseMove.y;
 				break;
 
+			case sf::Event::MouseWheelScrolled:
+				latency.begin_event();
+				if (event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel)
+				{
+					mouse_x = event.mouseWheelScroll.x;
+					mouse_y = event.mouseWheelScroll.y;
+					const ptrdiff_t notches = ptrdiff_t(std::lround(event.mouseWheelScroll.delta));
+					if (list_under_mouse().scroll(-notches * wheel_rows)) redraw = true;
+				}
+				break;
+
 			case sf::Event::MouseButtonPressed:
+				latency.begin_event();
 				if (event.mouseButton.button == sf::Mouse::Button::Left)
 					on_click();
 				break;
 
 			case sf::Event::KeyPressed:
+				latency.begin_event();
 				on_key_pressed(event.key);
 				break;
 
+			case sf::Event::Resized:
+			case sf::Event::GainedFocus:
+				redraw = true;
+				break;
+
 			case sf::Event::Closed:
 				window->close();
 				break;
+
+			default:
+				break;
 			}
-		}
+		} while (window->pollEvent(event));
 	}
 
-	void draw_box(const size_t x, const size_t y, const size_t width, const size_t height, const sf::Color color,
-		bool outline = false, const sf::Color outline_color = sf::Color::Black, const float outline_thickness = -2.f)
+	static void append_box(sf::VertexArray& quads, const float x, const float y, const float width, const float height, const sf::Color color,
+		const sf::Vector2f texture_position = {}, const sf::Vector2f texture_size = {})
 	{
-		sf::RectangleShape box{ { (float)width, (float)height } };
-		box.setPosition({ (float)x, (float)y });
-		box.setFillColor(color);
-
-		if (outline)
-		{
-			box.setOutlineColor(outline_color);
-			box.setOutlineThickness(outline_thickness);
-		}
-
-		window->draw(box);
+		quads.append({ { x, y }, color, texture_position });
+		quads.append({ { x + width, y }, color, { texture_position.x + texture_size.x, texture_position.y } });
+		quads.append({ { x + width, y + height }, color, { texture_position.x + texture_size.x, texture_position.y + texture_size.y } });
+		quads.append({ { x, y + height }, color, { texture_position.x, texture_position.y + texture_size.y } });
 	}
 
 	void update_solutions()
 	{
 		using namespace detail;
 
-		auto candidates = answer_list;
+		const int64_t filter_start = current_time_in_us();
 
-		for (size_t i = 0; i < rows; ++i)
-		{
-			for (size_t j = 0; j < word_length; ++j)
-			{
-				const Tile tile = board.board[i].guess[j];
-				if (tile.is_blank()) break;
+		absorb_speculation();
 
-				switch (tile.tile_color)
-				{
-				case tile_color::grey:
-					grey_filter(candidates, tile.c);
-					break;
-				case tile_color::yellow:
-					yellow_filter(candidates, tile.c, j);
-					break;
-				case tile_color::green:
-					green_filter(candidates, tile.c, j);
-					break;
-				default:
-					std::cout << "Invalid color??" << std::endl;
-					break;
-				}
-			}
+		/*
+		Toggling a tile back, or retyping a letter, returns to a board seen before, and setting the colors of a
+		row just typed goes to one worked out in the background, so its results are likely cached.
+		*/
+		const Solutions* cached = solutions_cache.find(board);
+		const bool scored = cached && cached->scored;
+		ranked_guesses_t cached_guesses;
+
+		if (cached)
+		{
+			candidates = cached->candidates;
+			if (scored) cached_guesses = cached->guesses;
+		}
+		else
+		{
+			candidates = filter_candidates(board);
+			solutions_cache.insert(board, { candidates, {}, false });
 		}
 
-		std::stringstream solutions;
+		const int64_t text_start = current_time_in_us();
+		latency.add(Latency_stage::filter, text_start - filter_start);
 
 		if (candidates.size() == 0)
 		{
-			solutions << "(no solutions)";
+			show_candidates(guess_list, "(no solutions)");
 		}
 		else if (candidates.size() < 3)
 		{
-			solutions << "try: \n\n";
-			solutions << "  " << candidates[0] << "\n\n";
-
-			if (candidates.size() == 2)
-			{
-				solutions << "or: \n\n";
-				solutions << "  " << candidates[1];
-			}
+			show_candidates(guess_list, "try:");
 		}
-		else // >2 valid answers, assess them
+		else if (scored)
 		{
-			const std::map<size_t, string_t> guesses = select_guesses(candidates, word_list);
+			scored_event = latency.current_event();
+			show_guesses(std::move(cached_guesses));
+		}
+		else // >2 valid answers, assess them in the background
+		{
+			guess_list.set_title("thinking...");
+			guess_list.set_items(0, nullptr);
+			scorer.submit([this, candidates = candidates] { return rank_guesses(candidates); });
+			scored_board = board;
+			scored_event = latency.current_event();
+			score_start = current_time_in_us();
+		}
 
-			if (guesses.size() == 0)
-			{
-				// Uncommon scenario where all answers use same letters
-				solutions << "try any of: \n\n";
-				for (auto word : candidates)
-					solutions << "  " << word << '\n';
-			}
-			else if (guesses.size() == 1)
-			{
-				auto it = guesses.rbegin();
+		// Nothing left to score, or the guesses were cached: a result for an earlier board must not show up.
+		if (candidates.size() < 3 || scored)
+			scorer.cancel();
 
-				solutions << "try: \n\n";
-				solutions << "  " << it->second << "\n\n";
-			}
-			else
-			{
-				auto it = guesses.rbegin();
+		show_candidates(candidate_list, std::to_string(candidates.size()) + (candidates.size() == 1 ? " candidate:" : " candidates:"));
+		latency.add(Latency_stage::text, current_time_in_us() - text_start);
 
-				solutions << "try: \n\n";
-				solutions << "  " << it->second << "\n\n";
-				solutions << "or: \n\n";
+		redraw = true;
+	}
 
-				++it;
-				for (size_t i = 0; i < 100 && it != guesses.rend(); ++i, ++it)
-				{
-					solutions << "  " << it->second << "\n";
-				}
-			}
+	/*
+	Greens are the strongest filter, so resolve them first, using the index, then check what's left against
+	every hint in one pass. Contradicting greens leave hints no word meets.
+	*/
+	std::vector<string_t> filter_candidates(const Board& hints_board) const
+	{
+		const Constraints<detail::word_length> hints = hints_board.constraints();
+		std::vector<string_t> filtered = candidate_index.green_candidates(hints.greens());
+		hints.filter(filtered);
+		return filtered;
+	}
+
+	/*
+	The guesses to suggest for these candidates, ranked by the histogram engine on the calling thread alone: the
+	speculator's threads already take the rest of the machine. Safe to call from any thread.
+	*/
+	ranked_guesses_t rank_guesses(const std::vector<string_t>& candidates_to_rank) const
+	{
+		Thread_pool caller_only{ 1 };
+		return rank_guesses_by_entropy(candidates_to_rank, word_list, caller_only);
+	}
+
+	// Everything update_solutions() shows for a board, worked out at once. Safe to call from any thread.
+	Solutions solve(const Board& hints_board) const
+	{
+		Solutions solutions;
+		solutions.candidates = filter_candidates(hints_board);
+		if (solutions.candidates.size() > 2)
+			solutions.guesses = rank_guesses(solutions.candidates);
+		solutions.scored = true;
+		return solutions;
+	}
+
+	/*
+	A row was just typed, and all its tiles are grey. Next, the user will click through its colors, to one of
+	243 patterns, so work each of them out in the background, starting with the patterns that the candidates
+	before this row make most likely.
+	*/
+	void speculate(const size_t row)
+	{
+		using namespace detail;
+
+		Board before = board;
+		for (size_t column = 0; column < word_length; ++column)
+			before.clear_tile(row, column);
+
+		const string_t guess = board.word(row);
+		std::vector<uint32_t> counts(pattern_count(word_length), 0);
+		for (const auto& candidate : filter_candidates(before))
+			++counts[get_pattern(guess, candidate)];
+
+		std::vector<uint32_t> patterns(counts.size());
+		for (uint32_t p = 0; p < patterns.size(); ++p)
+			patterns[p] = p;
+		std::stable_sort(patterns.begin(), patterns.end(), [&counts](const uint32_t a, const uint32_t b) { return counts[a] > counts[b]; });
+
+		std::vector<Speculator<Board, Solutions>::job_t> jobs;
+		for (const uint32_t pattern : patterns)
+		{
+			Board next = board;
+			for (uint32_t column = 0, p = pattern; column < word_length; ++column, p /= 3)
+				next.set_color(row, column, p % 3);
+
+			// the all-grey board is the one on screen, which update_solutions() takes care of
+			if (next == board) continue;
+
+			const Solutions* cached = solutions_cache.peek(next);
+			if (cached && cached->scored) continue;
+
+			jobs.push_back({ next, [this, next] { return solve(next); } });
 		}
 
-		overlay_right.setString(solutions.str());
+		speculator.start(std::move(jobs));
+	}
 
-		std::stringstream answers;
-		answers << candidates.size() << " candidate" << (candidates.size() == 1 ? "" : "s") << ":\n\n";
-		for (size_t i = 0; i < 100 && i < candidates.size(); ++i)
+	// Move what the speculator has finished into the cache.
+	void absorb_speculation()
+	{
+		for (auto& [speculative_board, solutions] : speculator.take())
+			solutions_cache.insert(speculative_board, std::move(solutions));
+	}
+
+	// List the current candidates. The list reads them as it scrolls, so they must not change while it shows them.
+	void show_candidates(Scroll_list& list, const std::string& title)
+	{
+		list.set_title(title);
+		list.set_items(candidates.size(), [this](const size_t i) { return "  " + std::string(candidates[i]); });
+	}
+
+	// Show the scorer's suggestions for the current candidates, best first, each with its entropy in bits.
+	void show_guesses(ranked_guesses_t scored)
+	{
+		const int64_t text_start = current_time_in_us();
+
+		guesses = std::move(scored);
+
+		if (guesses.size() == 0)
+		{
+			// Uncommon scenario where no word in the word list would tell us anything
+			show_candidates(guess_list, "try any of:");
+		}
+		else
 		{
-			answers << "  " << candidates[i] << '\n';
+			guess_list.set_title("try:");
+			guess_list.set_items(guesses.size(), [this](const size_t i)
+			{
+				char bits[16];
+				snprintf(bits, sizeof(bits), "%.2f", guesses[i].first);
+				return "  " + std::string(guesses[i].second) + "  " + bits;
+			});
 		}
 
-		overlay.setString(answers.str());
+		latency.add(Latency_stage::text, current_time_in_us() - text_start, scored_event);
+		redraw = true;
 	}
 
 	void tick()
@@ -372,53 +527,100 @@ public:
 		event handling or rendering.
 		*/
 
-		mouse_tile_x = (mouse_x - detail::board_x) / (detail::tile_size_px + detail::tile_padding_px);
-		mouse_tile_y = (mouse_y - detail::board_y) / (detail::tile_size_px + detail::tile_padding_px);
+		using namespace detail;
+
+		mouse_tile_x = (mouse_x - board_x) / (tile_size_px + tile_padding_px);
+		mouse_tile_y = (mouse_y - board_y) / (tile_size_px + tile_padding_px);
+
+		// The tile under the mouse is outlined, so moving onto another one needs a redraw.
+		const bool over_board = mouse_x > int32_t(board_x) && mouse_y > int32_t(board_y) &&
+			mouse_tile_x < word_length && mouse_tile_y < rows;
+		const size_t hovered = over_board ? mouse_tile_y * word_length + mouse_tile_x : no_tile;
+		if (hovered != hovered_tile)
+		{
+			hovered_tile = hovered;
+			board_dirty = true;
+			redraw = true;
+		}
+
+		absorb_speculation();
+
+		ranked_guesses_t scored;
+		if (scorer.take(scored))
+		{
+			latency.add(Latency_stage::score, current_time_in_us() - score_start, scored_event);
+
+			if (Solutions* entry = solutions_cache.peek(scored_board))
+			{
+				entry->guesses = scored;
+				entry->scored = true;
+			}
+
+			show_guesses(std::move(scored));
+		}
 	}
 
-	void render_game_board()
+	// Whether the row is still being typed, or spells a word from the word list.
+	bool is_legal_row(const size_t row) const
+	{
+		return !board.is_complete(row) || legal_words.contains(board.word(row));
+	}
+
+	/*
+	The board is drawn from two cached vertex arrays, one of tile quads and one of letter quads textured from
+	the font's glyph page, so it takes two draw calls. They are rebuilt only after the board changes.
+	*/
+	void build_game_board()
 	{
 		using namespace detail;
 
+		tile_vertices.clear();
+		letter_vertices.clear();
+
 		for (size_t i = 0; i < rows; ++i)
 		{
+			const sf::Color letter_color = is_legal_row(i) ? sf::Color::White : invalid_word;
+
 			for (size_t j = 0; j < word_length; ++j)
 			{
-				const Tile tile = board.board[i].guess[j];
-				sf::Color tile_color = grey;
+				const sf::Color tile_color = tile_colors[board.color(i, j)];
 
-				switch (tile.tile_color)
+				const float tile_x = float(board_x + (j * (tile_size_px + tile_padding_px)));
+				const float tile_y = float(board_y + (i * (tile_size_px + tile_padding_px)));
+				append_box(tile_vertices, tile_x, tile_y, float(tile_size_px), float(tile_size_px), tile_color);
+
+				if (board.is_blank(i, j)) continue;
+
+				// a tile with a letter can be clicked, so outline it when it's under the mouse
+				if (hovered_tile == i * word_length + j)
 				{
-				case tile_color::grey:
-					tile_color = grey;
-					break;
-				case tile_color::yellow:
-					tile_color = yellow;
-					break;
-				case tile_color::green:
-					tile_color = green;
-					break;
-				default:
-					std::cout << "Invalid color??" << std::endl;
-					break;
+					const float size = float(tile_size_px), edge = hover_outline_px;
+					append_box(tile_vertices, tile_x, tile_y, size, edge, hover_outline);
+					append_box(tile_vertices, tile_x, tile_y + size - edge, size, edge, hover_outline);
+					append_box(tile_vertices, tile_x, tile_y + edge, edge, size - 2 * edge, hover_outline);
+					append_box(tile_vertices, tile_x + size - edge, tile_y + edge, edge, size - 2 * edge, hover_outline);
 				}
 
-				const size_t tile_x = board_x + (j * (tile_size_px + tile_padding_px));
-				const size_t tile_y = board_y + (i * (tile_size_px + tile_padding_px));
-				draw_box(tile_x, tile_y, tile_size_px, tile_size_px, tile_color);
-
-				// draw the letter
+				// the letter, centered on the tile, and on whole pixels so it stays sharp
+				const sf::Glyph& glyph = letter_glyphs.glyph(board.letter(i, j));
+				const sf::IntRect& texture = glyph.textureRect;
+				append_box(letter_vertices,
+					std::floor(tile_x + (tile_size_px - glyph.bounds.width) / 2.f),
+					std::floor(tile_y + (tile_size_px - glyph.bounds.height) / 2.f),
+					glyph.bounds.width, glyph.bounds.height, letter_color,
+					{ float(texture.left), float(texture.top) }, { float(texture.width), float(texture.height) });
+			}
+		}
 
-				letter.setString(tile.c);
+		board_dirty = false;
+	}
 
-				sf::FloatRect bounds = letter.getLocalBounds();
-				letter.setPosition(
-					tile_x + tile_size_px / 2.f - bounds.width / 2.f - bounds.left,
-					tile_y + tile_size_px / 2.f - bounds.height / 2.f - bounds.top);
+	void render_game_board()
+	{
+		if (board_dirty) build_game_board();
 
-				window->draw(letter);
-			}
-		}
+		window->draw(tile_vertices);
+		window->draw(letter_vertices, sf::RenderStates{ &letter_glyphs.texture() });
 	}
 
 	void render()
@@ -427,20 +629,37 @@ public:
 
 		render_game_board();
 
-		window->draw(overlay);
-		window->draw(overlay_right);
+		candidate_list.draw(*window);
+		guess_list.draw(*window);
+
+		std::vector<std::string> lines = latency.summary();
+		char cache_line[64];
+		snprintf(cache_line, sizeof(cache_line), "cache    %3.0f%% of %zu hit", 100.0 * solutions_cache.hit_rate(),
+			solutions_cache.hits() + solutions_cache.misses());
+		lines.push_back(cache_line);
+
+		latency_overlay.set_rows(lines);
+		latency_overlay.draw(*window);
 	}
 
 public:
+	/*
+	Redraw only when something on screen changed: the board, the overlays, or the tile under the mouse. Between
+	events the loop sleeps in handle_events(), so an idle window costs next to nothing.
+	*/
 	void run()
 	{
 		while (window->isOpen())
 		{
 			handle_events();
 			tick();
-			render();
 
+			if (!redraw) continue;
+
+			render();
 			window->display();
+			latency.displayed();
+			redraw = false;
 		}
 	}
 
@@ -450,15 +669,43 @@ private:
 	int32_t mouse_x = 0, mouse_y = 0;
 
 	size_t mouse_tile_x = 0, mouse_tile_y = 0; // the tile under the mouse
+	static constexpr size_t no_tile = size_t(-1);
+	size_t hovered_tile = no_tile; // row * word_length + column, if the mouse is over the board
+	bool redraw = true; // something on screen changed since the last frame
 
 	std::unique_ptr<sf::RenderWindow> window;
-	sf::Font arial;
-	sf::Text overlay;
-	sf::Text overlay_right;
-	sf::Text letter;
+	sf::Font font;
+	Glyph_cache letter_glyphs;
+	Glyph_cache candidate_glyphs;
+	Glyph_cache suggestion_glyphs;
+	Glyph_cache latency_glyphs;
+	Scroll_list candidate_list;
+	Scroll_list guess_list;
+	Text_rows latency_overlay;
+
+	Latency_tracker latency;
+	uint64_t scored_event = 0; // the event whose candidates the scorer is working on
+	int64_t score_start = 0;
+
+	sf::VertexArray tile_vertices{ sf::Quads };
+	sf::VertexArray letter_vertices{ sf::Quads };
 
 	Board board;
+	bool board_dirty = true; // the cached vertex arrays are out of date
 
 	const std::vector<string_t> answer_list;
 	const std::vector<string_t> word_list;
+
+	const Candidate_index candidate_index;
+	const Word_set<> legal_words;
+
+	Lru_cache<Board, Solutions, Board::hasher> solutions_cache;
+	Board scored_board; // the board the scorer is working on
+
+	std::vector<string_t> candidates; // for the board as it is now
+	ranked_guesses_t guesses; // the scorer's latest result, for the candidates
+
+	// These two last, so they are destroyed first, and their threads stop before what their jobs use goes away.
+	Speculator<Board, Solutions> speculator;
+	Background_worker<ranked_guesses_t> scorer;
 };
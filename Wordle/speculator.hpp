@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utility.hpp"
+
+/*
+Work done ahead of time, on threads that would otherwise sit idle. A batch is a list of keyed jobs, most wanted
+first; the threads take them in order and collect the results for the caller to pick up, with their keys.
+Starting a batch drops whatever is left of the one before, and results of dropped jobs are thrown away.
+
+A job must only read what it is given, or what doesn't change while the batch runs.
+*/
+template<typename Key, typename Result>
+class Speculator
+{
+public:
+	using job_t = std::pair<Key, std::function<Result()>>;
+
+	// One thread per hardware thread but one, which is left to the GUI and its scorer.
+	explicit Speculator(const size_t threads = std::max<size_t>(1, thread_count() - 1))
+	{
+		for (size_t t = 0; t < threads; ++t)
+			workers.emplace_back([this] { work(); });
+	}
+
+	~Speculator()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	Speculator(const Speculator&) = delete;
+	Speculator& operator=(const Speculator&) = delete;
+
+	void start(std::vector<job_t> batch)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			jobs = std::move(batch);
+			next_job = 0;
+			++generation;
+			results.clear();
+		}
+		wake.notify_all();
+	}
+
+	void cancel() { start({}); }
+
+	// Move out the results finished since the last call.
+	std::vector<std::pair<Key, Result>> take()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		return std::exchange(results, {});
+	}
+
+private:
+	void work()
+	{
+		std::unique_lock<std::mutex> lock{ mutex };
+		while (true)
+		{
+			wake.wait(lock, [this] { return stopping || next_job < jobs.size(); });
+			if (stopping) return;
+
+			job_t job = std::move(jobs[next_job++]);
+			const uint64_t job_generation = generation;
+
+			lock.unlock();
+			Result result = job.second();
+			lock.lock();
+
+			if (job_generation == generation)
+				results.emplace_back(std::move(job.first), std::move(result));
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable wake;
+
+	std::vector<job_t> jobs;
+	size_t next_job = 0;
+	uint64_t generation = 0; // of the current batch
+	std::vector<std::pair<Key, Result>> results;
+	bool stopping = false;
+
+	std::vector<std::thread> workers; // last, so they start after everything they use is constructed
+};
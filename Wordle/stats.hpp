@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+What test() learns from a sweep, beyond how long it took: how many guesses each answer needed, which games went
+worst, and how many candidates were left and how long each turn took, on average.
+
+When the games are spread across threads, each thread gathers its own Test_stats, and they are merged once every
+game is done, so there is nothing shared between threads while they play.
+*/
+
+namespace detail
+{
+	constexpr size_t max_turns = 6;
+	constexpr size_t worst_games_kept = 10;
+
+	constexpr char stats_filename[] = "wordle_stats.json";
+}
+
+// How one game went. guesses is 0 if the game was lost.
+struct Game_result
+{
+	size_t guesses = 0;
+	size_t turns = 0;
+	size_t candidates_left = 0;
+	std::array<uint32_t, detail::max_turns> candidates{}; // before each guess
+	std::array<int64_t, detail::max_turns> turn_time_us{};
+
+	bool won() const { return guesses > 0; }
+};
+
+class Test_stats
+{
+public:
+	struct Game
+	{
+		size_t index = 0; // which game of the sweep
+		std::string answer;
+		Game_result result;
+	};
+
+	void add(const size_t index, const std::string& answer, const Game_result& result)
+	{
+		++games;
+		++guess_histogram[result.guesses];
+
+		if (result.won())
+		{
+			guess_sum += double(result.guesses);
+			guess_sum_of_squares += double(result.guesses) * double(result.guesses);
+		}
+		else
+		{
+			losses.push_back({ index, answer, result });
+		}
+
+		for (size_t turn = 0; turn < result.turns; ++turn)
+		{
+			++turn_count[turn];
+			candidate_sum[turn] += result.candidates[turn];
+			time_sum_us[turn] += result.turn_time_us[turn];
+		}
+
+		keep_if_worst({ index, answer, result });
+	}
+
+	void merge(const Test_stats& other)
+	{
+		games += other.games;
+		guess_sum += other.guess_sum;
+		guess_sum_of_squares += other.guess_sum_of_squares;
+
+		for (size_t i = 0; i < guess_histogram.size(); ++i)
+			guess_histogram[i] += other.guess_histogram[i];
+
+		for (size_t turn = 0; turn < detail::max_turns; ++turn)
+		{
+			turn_count[turn] += other.turn_count[turn];
+			candidate_sum[turn] += other.candidate_sum[turn];
+			time_sum_us[turn] += other.time_sum_us[turn];
+		}
+
+		losses.insert(losses.end(), other.losses.begin(), other.losses.end());
+		std::sort(losses.begin(), losses.end(), [](const Game& a, const Game& b) { return a.index < b.index; });
+
+		for (const Game& game : other.worst)
+			keep_if_worst(game);
+	}
+
+	// How many threads played the games. Their times per turn are only comparable with other runs on as many.
+	size_t threads() const { return thread_total; }
+	void set_threads(const size_t n) { thread_total = n; }
+
+	size_t wins() const { return games - guess_histogram[0]; }
+	double mean() const { return wins() > 0 ? guess_sum / wins() : 0.0; }
+
+	double variance() const
+	{
+		if (wins() == 0) return 0.0;
+		const double m = mean();
+		return std::max(0.0, guess_sum_of_squares / wins() - m * m);
+	}
+
+	// Lost games, in the order they were played.
+	const std::vector<Game>& lost_games() const { return losses; }
+
+	void print(std::ostream& out) const
+	{
+		out << "Won " << wins() << " of " << games << ", " << mean() << " guesses on average (standard deviation " << std::sqrt(variance()) << ")\n";
+
+		for (size_t guesses = 1; guesses <= detail::max_turns; ++guesses)
+			out << "  " << guesses << ": " << guess_histogram[guesses] << '\n';
+		out << "  lost: " << guess_histogram[0] << '\n';
+
+		out << "\nTurn\tCandidates\tus\n";
+		for (size_t turn = 0; turn < detail::max_turns && turn_count[turn] > 0; ++turn)
+			out << (turn + 1) << '\t' << double(candidate_sum[turn]) / turn_count[turn] << "\t\t" << double(time_sum_us[turn]) / turn_count[turn] << '\n';
+
+		out << "\nWorst games:\n";
+		for (const Game& game : worst)
+			out << "  " << game.answer << ": " << (game.result.won() ? std::to_string(game.result.guesses) + " guesses" : "lost") << '\n';
+	}
+
+	void write_json(std::ostream& out) const
+	{
+		out << "{\n\t\"games\": " << games << ",\n\t\"threads\": " << thread_total << ",\n\t\"wins\": " << wins()
+			<< ",\n\t\"mean_guesses\": " << mean() << ",\n\t\"variance\": " << variance()
+			<< ",\n\t\"guess_histogram\": { ";
+		for (size_t guesses = 1; guesses <= detail::max_turns; ++guesses)
+			out << '"' << guesses << "\": " << guess_histogram[guesses] << ", ";
+		out << "\"lost\": " << guess_histogram[0] << " },\n\t\"turns\": [";
+
+		for (size_t turn = 0; turn < detail::max_turns && turn_count[turn] > 0; ++turn)
+			out << (turn ? ", " : "") << "\n\t\t{ \"games\": " << turn_count[turn]
+				<< ", \"mean_candidates\": " << double(candidate_sum[turn]) / turn_count[turn]
+				<< ", \"mean_time_us\": " << double(time_sum_us[turn]) / turn_count[turn] << " }";
+
+		out << "\n\t],\n\t\"worst\": [";
+		for (size_t i = 0; i < worst.size(); ++i)
+			out << (i ? ", " : "") << "{ \"answer\": \"" << worst[i].answer << "\", \"guesses\": " << worst[i].result.guesses << " }";
+
+		out << "],\n\t\"lost\": [";
+		for (size_t i = 0; i < losses.size(); ++i)
+			out << (i ? ", " : "") << "{ \"answer\": \"" << losses[i].answer << "\", \"candidates_left\": " << losses[i].result.candidates_left << " }";
+		out << "]\n}\n";
+	}
+
+	bool write_json(const std::string& filename) const
+	{
+		std::ofstream out{ filename };
+		write_json(out);
+		return bool(out);
+	}
+
+private:
+	// Worse means lost, then more guesses, then played earlier.
+	static bool worse(const Game& a, const Game& b)
+	{
+		if (a.result.won() != b.result.won()) return !a.result.won();
+		if (a.result.guesses != b.result.guesses) return a.result.guesses > b.result.guesses;
+		return a.index < b.index;
+	}
+
+	void keep_if_worst(const Game& game)
+	{
+		if (worst.size() == detail::worst_games_kept && !worse(game, worst.back())) return;
+
+		worst.insert(std::upper_bound(worst.begin(), worst.end(), game, worse), game);
+		if (worst.size() > detail::worst_games_kept) worst.pop_back();
+	}
+
+	size_t games = 0;
+	size_t thread_total = 1;
+	std::array<size_t, detail::max_turns + 1> guess_histogram{}; // by guesses, with losses at 0
+	double guess_sum = 0.0, guess_sum_of_squares = 0.0; // over won games
+
+	std::array<size_t, detail::max_turns> turn_count{};
+	std::array<uint64_t, detail::max_turns> candidate_sum{};
+	std::array<int64_t, detail::max_turns> time_sum_us{};
+
+	std::vector<Game> worst; // sorted, worst first
+	std::vector<Game> losses;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+Text drawn straight from the font's glyph texture, without sf::Text. sf::Text lays out every glyph of its string
+again whenever the string changes. Everything the GUI prints is short lines of ASCII, mostly 5-letter words, so
+the glyphs are looked up once and each line gets a fixed block of quads that is only rewritten if that line
+changes.
+*/
+
+// The printable ASCII glyphs of one font at one size, loaded up front.
+class Glyph_cache
+{
+public:
+	/*
+	The font adds glyphs to its texture as they are first used, which can move the ones already there, so all
+	of them are loaded at once, before any texture coordinates are taken.
+	*/
+	void load(const sf::Font& set_font, const uint32_t set_character_size)
+	{
+		font = &set_font;
+		character_size = set_character_size;
+
+		for (size_t i = 0; i < glyphs.size(); ++i)
+			glyphs[i] = font->getGlyph(uint32_t(first + i), character_size, false);
+
+		spacing = font->getLineSpacing(character_size);
+	}
+
+	// Anything outside printable ASCII shows as '?'.
+	const sf::Glyph& glyph(const char c) const
+	{
+		return (c >= first && c <= last) ? glyphs[c - first] : glyphs['?' - first];
+	}
+
+	uint32_t size() const { return character_size; }
+	float line_spacing() const { return spacing; }
+	const sf::Texture& texture() const { return font->getTexture(character_size); }
+
+private:
+	static constexpr char first = ' ';
+	static constexpr char last = '~';
+
+	const sf::Font* font = nullptr;
+	uint32_t character_size = 0;
+	float spacing = 0.f;
+	std::array<sf::Glyph, last - first + 1> glyphs;
+};
+
+/*
+A fixed number of lines, each with room for a fixed number of characters; longer lines are cut off. Lines are
+placed as sf::Text would place them, the first baseline one character size below the top.
+*/
+class Text_rows
+{
+public:
+	Text_rows(const Glyph_cache& set_glyphs, const sf::Vector2f set_position, const size_t set_rows, const size_t set_columns,
+		const sf::Color set_color = sf::Color::White) :
+		glyphs{ set_glyphs },
+		position{ set_position },
+		columns{ set_columns },
+		color{ set_color },
+		texts(set_rows),
+		vertices{ sf::Quads, set_rows * set_columns * 4 } {}
+
+	size_t rows() const { return texts.size(); }
+
+	// Set one line. Its quads are only rewritten if the text is different.
+	void set_row(const size_t row, const std::string& text)
+	{
+		if (row >= texts.size() || texts[row] == text) return;
+		texts[row] = text;
+
+		const float baseline = position.y + glyphs.size() + row * glyphs.line_spacing();
+		float x = position.x;
+
+		for (size_t i = 0; i < columns; ++i)
+		{
+			sf::Vertex* const quad = &vertices[(row * columns + i) * 4];
+
+			if (i >= text.size() || text[i] == ' ')
+			{
+				// nothing to draw: an empty quad
+				for (size_t k = 0; k < 4; ++k)
+					quad[k] = sf::Vertex{ { x, baseline }, sf::Color::Transparent };
+				if (i < text.size()) x += glyphs.glyph(' ').advance;
+				continue;
+			}
+
+			const sf::Glyph& glyph = glyphs.glyph(text[i]);
+			const float left = x + glyph.bounds.left, top = baseline + glyph.bounds.top;
+			const float right = left + glyph.bounds.width, bottom = top + glyph.bounds.height;
+			const sf::IntRect& t = glyph.textureRect;
+
+			quad[0] = sf::Vertex{ { left, top }, color, { float(t.left), float(t.top) } };
+			quad[1] = sf::Vertex{ { right, top }, color, { float(t.left + t.width), float(t.top) } };
+			quad[2] = sf::Vertex{ { right, bottom }, color, { float(t.left + t.width), float(t.top + t.height) } };
+			quad[3] = sf::Vertex{ { left, bottom }, color, { float(t.left), float(t.top + t.height) } };
+
+			x += glyph.advance;
+		}
+	}
+
+	// Set every line: the first lines.size() from lines, and the rest blank.
+	void set_rows(const std::vector<std::string>& lines)
+	{
+		for (size_t row = 0; row < texts.size(); ++row)
+			set_row(row, row < lines.size() ? lines[row] : std::string{});
+	}
+
+	void draw(sf::RenderTarget& target) const
+	{
+		target.draw(vertices, sf::RenderStates{ &glyphs.texture() });
+	}
+
+private:
+	const Glyph_cache& glyphs;
+	const sf::Vector2f position;
+	const size_t columns;
+	const sf::Color color;
+
+	std::vector<std::string> texts;
+	sf::VertexArray vertices;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utility.hpp"
+
+/*
+parallel_for() on threads that are started once and then wait for work, for loops that run it over and over,
+where starting a thread per chunk would cost as much as the chunk. The calling thread processes the first chunk,
+as in parallel_for(). One loop runs at a time.
+*/
+class Thread_pool
+{
+public:
+	explicit Thread_pool(const size_t threads = thread_count())
+	{
+		for (size_t t = 1; t < threads; ++t)
+			workers.emplace_back([this, t] { work(t); });
+	}
+
+	~Thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	Thread_pool(const Thread_pool&) = delete;
+	Thread_pool& operator=(const Thread_pool&) = delete;
+
+	// The number of threads, counting the caller's: thread indexes passed to f are below this.
+	size_t size() const { return workers.size() + 1; }
+
+	// Split [0, count) into one contiguous chunk per thread, and call f(begin, end, thread_index) for each chunk.
+	template<typename F>
+	void parallel_for(const size_t count, F&& f)
+	{
+		const size_t chunk = (count + size() - 1) / size();
+		const std::function<void(size_t)> task = [&f, count, chunk](const size_t thread)
+		{
+			const size_t begin = std::min(count, thread * chunk);
+			const size_t end = std::min(count, begin + chunk);
+			if (begin < end) f(begin, end, thread);
+		};
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			job = &task;
+			running = workers.size();
+			++generation;
+		}
+		wake.notify_all();
+
+		task(0);
+
+		std::unique_lock<std::mutex> lock{ mutex };
+		done.wait(lock, [this] { return running == 0; });
+		job = nullptr;
+	}
+
+private:
+	void work(const size_t thread)
+	{
+		uint64_t seen = 0;
+		std::unique_lock<std::mutex> lock{ mutex };
+		while (true)
+		{
+			wake.wait(lock, [this, &seen] { return stopping || generation != seen; });
+			if (stopping) return;
+
+			seen = generation;
+			const std::function<void(size_t)>* task = job;
+
+			lock.unlock();
+			(*task)(thread);
+			lock.lock();
+
+			if (--running == 0)
+				done.notify_one();
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void(size_t)>* job = nullptr;
+	size_t running = 0; // workers still on the current loop
+	uint64_t generation = 0; // of the current loop
+	bool stopping = false;
+
+	std::vector<std::thread> workers; // last, so they start after everything they use is constructed
+};
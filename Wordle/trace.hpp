@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Per-game traces, for finding out why a game went the way it did without slowing the sweep down. Each game
+fills in one fixed-size record: the answer, then every guess with its pattern and the number of candidates
+left before it. Records go into a ring buffer owned by the game's thread, and a writer thread drains the
+rings to a file in the background, so a game never waits on I/O unless its ring is full.
+
+Tracing is chosen at compile time: build with WORDLE_TRACE=1 to turn it on. When it is off, every use of it
+sits behind "if constexpr (detail::tracing)" and compiles to nothing.
+*/
+
+#ifndef WORDLE_TRACE
+#define WORDLE_TRACE 0
+#endif
+
+namespace detail
+{
+	constexpr bool tracing = WORDLE_TRACE != 0;
+
+	constexpr size_t trace_max_turns = 8;
+	constexpr size_t trace_word_size = 8; // room for the longest supported word
+	constexpr size_t trace_ring_size = 4096; // records per thread
+	constexpr uint32_t trace_magic = 0x43525457; // "WTRC"
+	constexpr uint32_t trace_version = 1;
+
+	constexpr char trace_filename[] = "wordle_trace.bin";
+}
+
+struct Game_record
+{
+	char answer[detail::trace_word_size]{};
+	char guesses[detail::trace_max_turns][detail::trace_word_size]{};
+	uint16_t patterns[detail::trace_max_turns]{};
+	uint32_t candidates[detail::trace_max_turns]{}; // before each guess
+	uint8_t turns = 0;
+	uint8_t won = 0;
+	uint8_t unused[2]{}; // so there are no padding bytes, and records compare with memcmp()
+
+	template<typename W>
+	void set_answer(const W& word) { copy(word, answer); }
+
+	// Record a guess, its pattern, and how many candidates there were to choose from. Turns past the last are dropped.
+	template<typename W>
+	void add_turn(const W& guess, const uint32_t pattern, const size_t candidate_count)
+	{
+		if (turns == detail::trace_max_turns) return;
+
+		copy(guess, guesses[turns]);
+		patterns[turns] = uint16_t(pattern);
+		candidates[turns] = uint32_t(candidate_count);
+		++turns;
+	}
+
+private:
+	template<typename W>
+	static void copy(const W& word, char* const target)
+	{
+		const size_t n = std::min<size_t>(word.size(), detail::trace_word_size);
+		std::memcpy(target, word.data(), n);
+	}
+};
+
+static_assert(sizeof(Game_record) == 124, "Game_record is written to disk as is, and must have no padding");
+
+struct Trace_file_header
+{
+	uint32_t magic = detail::trace_magic;
+	uint32_t version = detail::trace_version;
+	uint32_t record_size = uint32_t(sizeof(Game_record));
+	uint32_t reserved = 0;
+};
+
+namespace detail
+{
+	// A single-producer, single-consumer ring: the game thread pushes, the writer thread pops.
+	struct Trace_ring
+	{
+		std::vector<Game_record> records = std::vector<Game_record>(trace_ring_size);
+		std::atomic<size_t> head{ 0 }; // next to write; only the producer moves it
+		std::atomic<size_t> tail{ 0 }; // next to read; only the consumer moves it
+	};
+
+	class Trace_sink
+	{
+	public:
+		bool open(const std::string& filename)
+		{
+			close();
+
+			out.open(filename, std::ios::binary | std::ios::trunc);
+			if (!out) return false;
+
+			const Trace_file_header header;
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			++generation;
+			running = true;
+			writer = std::thread{ [this] { write_loop(); } };
+			return true;
+		}
+
+		void close()
+		{
+			if (!writer.joinable()) return;
+
+			running = false;
+			writer.join();
+			drain();
+			out.close();
+
+			std::lock_guard<std::mutex> lock{ rings_mutex };
+			rings.clear();
+		}
+
+		// Queue a record. Waits only if this thread's ring is full.
+		void push(const Game_record& record)
+		{
+			if (!running) return;
+
+			Trace_ring& ring = local_ring();
+			const size_t head = ring.head.load(std::memory_order_relaxed);
+			while (head - ring.tail.load(std::memory_order_acquire) == trace_ring_size)
+				std::this_thread::yield();
+
+			ring.records[head % trace_ring_size] = record;
+			ring.head.store(head + 1, std::memory_order_release);
+		}
+
+		~Trace_sink() { close(); }
+
+	private:
+		Trace_ring& local_ring()
+		{
+			thread_local Trace_ring* ring = nullptr;
+			thread_local size_t ring_generation = 0;
+
+			if (ring == nullptr || ring_generation != generation)
+			{
+				std::lock_guard<std::mutex> lock{ rings_mutex };
+				rings.push_back(std::make_unique<Trace_ring>());
+				ring = rings.back().get();
+				ring_generation = generation;
+			}
+			return *ring;
+		}
+
+		// Write out everything queued so far. Returns the number of records written.
+		size_t drain()
+		{
+			std::lock_guard<std::mutex> lock{ rings_mutex };
+
+			size_t written = 0;
+			for (const auto& ring : rings)
+			{
+				const size_t head = ring->head.load(std::memory_order_acquire);
+				size_t tail = ring->tail.load(std::memory_order_relaxed);
+				for (; tail != head; ++tail, ++written)
+					out.write(reinterpret_cast<const char*>(&ring->records[tail % trace_ring_size]), sizeof(Game_record));
+				ring->tail.store(tail, std::memory_order_release);
+			}
+			return written;
+		}
+
+		void write_loop()
+		{
+			while (running)
+				if (drain() == 0)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		std::ofstream out;
+		std::thread writer;
+		std::atomic<bool> running{ false };
+		std::atomic<size_t> generation{ 0 };
+
+		std::mutex rings_mutex;
+		std::vector<std::unique_ptr<Trace_ring>> rings;
+	};
+
+	Trace_sink& trace_sink()
+	{
+		static Trace_sink sink;
+		return sink;
+	}
+}
+
+// Start writing game records to this file, replacing it. Games already queued for another file are flushed first.
+bool open_trace(const std::string& filename = detail::trace_filename) { return detail::trace_sink().open(filename); }
+
+// Flush every queued record and close the file.
+void close_trace() { detail::trace_sink().close(); }
+
+void trace_game(const Game_record& record) { detail::trace_sink().push(record); }
+
+std::vector<Game_record> load_trace(const std::string& filename)
+{
+	std::ifstream in{ filename, std::ios::binary };
+
+	Trace_file_header header;
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!in || header.magic != detail::trace_magic || header.version != detail::trace_version || header.record_size != sizeof(Game_record))
+	{
+		std::cout << "Not a trace file, or from another version: " << filename << '\n';
+		return {};
+	}
+
+	std::vector<Game_record> records;
+	Game_record record;
+	while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+		records.push_back(record);
+	return records;
+}
+
+// One game, turn by turn. Pattern letters are G for green, Y for yellow and - for grey.
+void print_game(const Game_record& record)
+{
+	const size_t length = strnlen(record.answer, detail::trace_word_size);
+
+	std::cout << std::string(record.answer, length) << (record.won ? ", won in " : ", lost after ") << int(record.turns) << ":\n";
+	for (size_t turn = 0; turn < record.turns; ++turn)
+	{
+		std::string pattern;
+		for (uint32_t p = record.patterns[turn], i = 0; i < length; ++i, p /= 3)
+			pattern += "-YG"[p % 3];
+
+		std::cout << "  " << std::string(record.guesses[turn], length) << ' ' << pattern
+			<< "  (" << record.candidates[turn] << (record.candidates[turn] == 1 ? " candidate)\n" : " candidates)\n");
+	}
+}
+
+/*
+Compare two traces game by game, matching games by answer, and print every game that was played differently,
+turn by turn in both runs.
+*/
+void diff_traces(const std::string& before_filename, const std::string& after_filename)
+{
+	const auto index = [](const std::vector<Game_record>& records)
+	{
+		std::map<std::string, const Game_record*> games;
+		for (const auto& record : records)
+			games[std::string(record.answer, strnlen(record.answer, detail::trace_word_size))] = &record;
+		return games;
+	};
+
+	const std::vector<Game_record> before = load_trace(before_filename), after = load_trace(after_filename);
+	const auto before_games = index(before), after_games = index(after);
+
+	size_t same = 0, changed = 0, missing = 0;
+	size_t before_turns = 0, after_turns = 0, before_wins = 0, after_wins = 0;
+
+	for (const auto& [answer, a] : before_games)
+	{
+		const auto it = after_games.find(answer);
+		if (it == after_games.end())
+		{
+			++missing;
+			continue;
+		}
+
+		const Game_record* b = it->second;
+		before_turns += a->turns;
+		after_turns += b->turns;
+		before_wins += a->won;
+		after_wins += b->won;
+
+		if (std::memcmp(a, b, sizeof(Game_record)) == 0)
+		{
+			++same;
+			continue;
+		}
+
+		++changed;
+		std::cout << "\nBefore: ";
+		print_game(*a);
+		std::cout << "After: ";
+		print_game(*b);
+	}
+
+	const size_t compared = same + changed;
+	std::cout << "\nCompared " << compared << " games: " << same << " the same, " << changed << " different, "
+		<< missing + (after_games.size() - compared) << " in only one trace.\n"
+		<< "Wins: " << before_wins << " before, " << after_wins << " after. Guesses per game: "
+		<< (compared ? double(before_turns) / compared : 0.0) << " before, "
+		<< (compared ? double(after_turns) / compared : 0.0) << " after.\n";
+}
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <chrono>
+#include <thread>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 size_t random_int_from(const size_t min, const size_t max)
 {
@@ -15,6 +22,18 @@ auto contains(const C& container, const T& element)
 	return std::find(begin(container), end(container), element) != end(container);
 }
 
+// x must be non-zero
+uint32_t count_trailing_zeros(const uint32_t x)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return uint32_t(index);
+#else
+	return uint32_t(__builtin_ctz(x));
+#endif
+}
+
 auto current_time_in_ms()
 {
 	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -24,3 +43,32 @@ auto current_time_in_us()
 {
 	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
+
+size_t thread_count()
+{
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*
+Split [0, count) into one contiguous chunk per hardware thread, and call f(begin, end, thread_index) for each
+chunk in parallel. The calling thread processes the first chunk. Returns once every chunk is done.
+*/
+template<typename F>
+void parallel_for(const size_t count, F&& f)
+{
+	const size_t threads = std::max<size_t>(1, std::min(thread_count(), count));
+	const size_t chunk = (count + threads - 1) / threads;
+
+	std::vector<std::thread> workers;
+	for (size_t t = 1; t < threads; ++t)
+	{
+		const size_t begin = std::min(count, t * chunk);
+		const size_t end = std::min(count, begin + chunk);
+		workers.emplace_back([&f, begin, end, t] { f(begin, end, t); });
+	}
+
+	f(0, std::min(count, chunk), 0);
+
+	for (auto& worker : workers)
+		worker.join();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "wordle.hpp"
+
+/*
+Words packed 5 bits per letter, first letter in the highest bits. A 5-letter word fits in 25 bits, and codes
+sort in the same order as the words they encode.
+*/
+template<size_t length>
+using word_code_t = std::conditional_t<(5 * length <= 32), uint32_t, uint64_t>;
+
+template<size_t length>
+word_code_t<length> pack(const word_t<length>& word)
+{
+	word_code_t<length> code = 0;
+	for (size_t i = 0; i < length; ++i)
+		code = (code << 5) | word_code_t<length>(word[i] - detail::letter_a);
+	return code;
+}
+
+template<size_t length>
+word_t<length> unpack(word_code_t<length> code)
+{
+	char letters[length];
+	for (size_t i = length; i-- > 0; code >>= 5)
+		letters[i] = char(detail::letter_a + (code & 31));
+	return word_t<length>(letters, length);
+}
+
+/*
+An immutable set of words, stored as one flat sorted array of packed codes. Membership and word-to-index
+lookups are a branch-free binary search: the loop always runs log2(n) times, and each step is a conditional
+move rather than a branch the CPU has to predict.
+*/
+template<size_t length = detail::word_length>
+class Word_set
+{
+public:
+	using code_t = word_code_t<length>;
+
+	static constexpr size_t npos = size_t(-1);
+
+	Word_set() = default;
+
+	explicit Word_set(const std::vector<word_t<length>>& words)
+	{
+		codes.reserve(words.size());
+		for (const auto& word : words)
+			codes.push_back(pack(word));
+
+		std::sort(codes.begin(), codes.end());
+		codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+	}
+
+	// The index of this word in the set (in sorted order), or npos.
+	size_t index_of(const word_t<length>& word) const
+	{
+		if (codes.empty()) return npos;
+
+		const code_t key = pack(word);
+		const code_t* base = codes.data();
+		size_t n = codes.size();
+
+		while (n > 1)
+		{
+			const size_t half = n / 2;
+			base = (base[half] <= key) ? base + half : base;
+			n -= half;
+		}
+
+		return (*base == key) ? size_t(base - codes.data()) : npos;
+	}
+
+	bool contains(const word_t<length>& word) const { return index_of(word) != npos; }
+
+	word_t<length> operator[](const size_t index) const { return unpack<length>(codes[index]); }
+
+	size_t size() const { return codes.size(); }
+	bool empty() const { return codes.empty(); }
+
+private:
+	std::vector<code_t> codes;
+};
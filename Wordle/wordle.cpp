@@ -1,8 +1,10 @@
+#include <iostream>
+#include <string>
 
 #include "solver.hpp"
 #include "wordle.hpp"
 
-int main()
+int main(int argc, char** argv)
 {
 	srand(4);
 
@@ -12,5 +14,13 @@ int main()
 		load_wordlist("wordle_nyt.txt"),
 		load_wordlist("wordle_nyt.txt") };
 
+	// --latency-log [file] records how long each solve takes.
+	if (argc >= 2 && std::string(argv[1]) == "--latency-log")
+	{
+		const std::string filename = (argc >= 3) ? argv[2] : detail::latency_filename;
+		if (!solver.log_latency(filename))
+			std::cout << "Couldn't open " << filename << " for the latency log.\n";
+	}
+
 	solver.run();
 }
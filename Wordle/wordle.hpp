@@ -1,163 +1,243 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-#include "boost_static_string.hpp"
-
+#include "histogram_engine.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 #include "utility.hpp"
+#include "words.hpp"
 
-namespace detail
+/*
+1. If we find a correct letter, remove:
+	- every candidate that does not have that letter in that position
+*/
+template<size_t length>
+void green_filter(std::vector<word_t<length>>& candidates, const char c, const size_t position)
 {
-	constexpr size_t word_length = 5;
-
-	constexpr char letter_a = 'A'; // These are here because some optimizations are case-sensitive.
-	constexpr char letter_z = 'Z';
+	candidates.erase(std::remove_if(candidates.begin(),
+		candidates.end(),
+		[c, position](const word_t<length>& x) { return x[position] != c; }),
+		candidates.end());
 }
 
-using string_t = boost::static_string<detail::word_length>;
-
-std::vector<string_t> load_norvig_words(const size_t word_list_size)
+/*
+2. If we find a letter that is used, but in a different position, remove:
+	- every candidate that uses that letter in that position, and
+	- every candidate that does not use that letter
+*/
+template<size_t length>
+void yellow_filter(std::vector<word_t<length>>& candidates, const char c, const size_t position)
 {
-	std::fstream word_file("../Wordle/norvig_count_1w.txt");
+	candidates.erase(std::remove_if(candidates.begin(),
+		candidates.end(),
+		[c, position](const word_t<length>& x) { return !contains(x, c) || x[position] == c; }),
+		candidates.end());
+}
 
-	std::string word;
-	size_t count;
+/*
+3. If we find a letter that is not used, remove:
+	- every candidate that contains that letter
+*/
+template<size_t length>
+void grey_filter(std::vector<word_t<length>>& candidates, const char c)
+{
+	candidates.erase(std::remove_if(candidates.begin(),
+		candidates.end(),
+		[c](const word_t<length>& x) { return contains(x, c); }),
+		candidates.end());
+}
 
-	std::vector<string_t> word_list;
-	word_list.reserve(word_list_size);
+/*
+4. Every hint revealed so far, compiled into letter bitmasks. A word can then be checked against all of the
+hints in one pass, instead of running one of the filters above per hint.
+*/
+template<size_t length>
+class Constraints
+{
+public:
+	void add_green(const char c, const size_t position) { green[position] = c; }
 
-	while (word_file >> word >> count && word_list.size() < word_list_size)
+	void add_yellow(const char c, const size_t position)
 	{
-		if (word.size() != detail::word_length) continue;
+		required |= bit(c);
+		excluded[position] |= bit(c);
+	}
 
-		transform(word.begin(), word.end(), word.begin(), ::toupper);
+	void add_grey(const char c) { absent |= bit(c); }
 
-		word_list.push_back(word.c_str());
-	}
+	/*
+	Add a row of feedback: the guess, and its pattern as get_pattern() gives it. The guess may be shorter than a
+	word, for a row that's still being typed. Repeated letters are graded as Wordle grades them, so a letter that
+	is yellow or green in the row and also grey tells us how many times the answer uses it, not that it's absent.
 
-	return word_list;
-}
+	Each tile is added by its pattern digit, without branching on the color. A green that contradicts an earlier
+	green in the same place can't be met by any word, so it rules them all out.
+	*/
+	void add_pattern(const word_t<length>& guess, uint32_t pattern)
+	{
+		std::array<uint8_t, 26> shown{}; // yellow and green tiles of each letter
+		uint32_t greyed = 0;
 
-std::map<string_t, size_t> load_norvig_words_with_frequencies()
-{
-	std::fstream word_file("../Wordle/norvig_count_1w.txt");
+		for (size_t i = 0; i < guess.size(); ++i, pattern /= 3)
+		{
+			const char c = guess[i];
+			const uint32_t digit = pattern % 3;
+			const uint32_t b = bit(c);
+			const uint32_t grey = 0u - uint32_t(digit == 0), green_hint = 0u - uint32_t(digit == 2);
+			const uint32_t conflict = 0u - uint32_t(green[i] != 0 && green[i] != c);
+
+			// a grey or yellow letter is not the answer's letter here
+			excluded[i] |= b & ~green_hint;
+			absent |= green_hint & conflict;
+			green[i] = green_hint ? c : green[i];
+
+			shown[c - detail::letter_a] += uint8_t(digit != 0);
+			greyed |= b & grey;
+		}
 
-	std::string word;
-	size_t count;
+		for (size_t i = 0; i < guess.size(); ++i)
+		{
+			const size_t c = size_t(guess[i] - detail::letter_a);
+			const uint32_t b = bit(guess[i]);
+			const uint8_t n = shown[c];
+			const bool capped = (greyed & b) != 0;
+
+			// at least n of the letter, and if one of them was grey, exactly n
+			required |= b & (0u - uint32_t(n > 0));
+			absent |= b & (0u - uint32_t(capped && n == 0));
+			min_count[c] = std::max(min_count[c], n);
+			max_count[c] = capped ? std::min(max_count[c], n) : max_count[c];
+			counted |= b & (0u - uint32_t(n > 1 || (capped && n > 0)));
+		}
+	}
 
-	std::map<string_t, size_t> word_list;
+	// The green letter at each position, or 0 where there is none.
+	const std::array<char, length>& greens() const { return green; }
 
-	while (word_file >> word >> count)
+	// Add the hints revealed by guessing this word against the answer.
+	void add_feedback(const word_t<length>& guess, const word_t<length>& answer)
 	{
-		if (word.size() != detail::word_length) continue;
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (guess[i] == answer[i])
+				add_green(guess[i], i);
+			else if (contains(answer, guess[i]))
+				add_yellow(guess[i], i);
+			else
+				add_grey(guess[i]);
+		}
+	}
 
-		transform(word.begin(), word.end(), word.begin(), ::toupper);
+	bool allows(const word_t<length>& word) const
+	{
+		uint32_t letters = 0;
+		uint32_t misplaced = 0;
 
-		if (contains(word, 'A') ||
-			contains(word, 'E') ||
-			contains(word, 'I') ||
-			contains(word, 'O') ||
-			contains(word, 'U') ||
-			contains(word, 'Y'))
+		for (size_t i = 0; i < length; ++i)
 		{
-			word_list.insert({ string_t(word), count });
+			letters |= bit(word[i]);
+			misplaced |= (green[i] != 0 && word[i] != green[i]) | ((excluded[i] & bit(word[i])) != 0);
 		}
-	}
 
-	return word_list;
-}
+		if (misplaced || (letters & absent) != 0 || (letters & required) != required)
+			return false;
 
-std::vector<string_t> load_wordle_nyt_words()
-{
-	assert(detail::word_length == 5);
+		// Letters whose count is known need counting, but few hints give one.
+		for (uint32_t rest = counted; rest != 0; rest &= rest - 1)
+		{
+			const uint32_t c = count_trailing_zeros(rest);
+			uint8_t n = 0;
+			for (size_t i = 0; i < length; ++i)
+				n += uint8_t(word[i] == char(detail::letter_a + c));
 
-	std::fstream word_file("../../../../Documents/word lists/wordle_nyt.txt");
+			if (n < min_count[c] || n > max_count[c])
+				return false;
+		}
 
-	std::string word;
-	std::vector<string_t> word_list;
-	while (word_file >> word)
-	{
-		if (word.size() != detail::word_length) continue;
-		transform(word.begin(), word.end(), word.begin(), ::toupper);
-		word_list.push_back(string_t(word));
+		return true;
 	}
 
-	return word_list;
-}
+	void filter(std::vector<word_t<length>>& words) const
+	{
+		words.erase(std::remove_if(words.begin(),
+			words.end(),
+			[this](const word_t<length>& x) { return !allows(x); }),
+			words.end());
+	}
 
-std::vector<string_t> load_wordlist(const std::string& filename)
-{
-	assert(detail::word_length == 5);
+	// Filter the words, keeping a parallel array of per-word values aligned with them.
+	template<typename T>
+	void filter(std::vector<word_t<length>>& words, std::vector<T>& values) const
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < words.size(); ++i)
+		{
+			if (!allows(words[i])) continue;
+			words[kept] = words[i];
+			values[kept] = values[i];
+			++kept;
+		}
 
-	std::fstream word_file("../../../../Documents/word lists/" + filename);
+		words.resize(kept);
+		values.resize(kept);
+	}
 
-	std::string word;
-	std::vector<string_t> word_list;
-	while (word_file >> word)
+	// The subset of these hints that NYT hard mode enforces: greens stay in place, and yellows must be reused.
+	Constraints hard_mode() const
 	{
-		if (word.size() != detail::word_length) continue;
-		transform(word.begin(), word.end(), word.begin(), ::toupper);
-		word_list.push_back(string_t(word));
+		Constraints hard;
+		hard.green = green;
+		hard.required = required;
+		return hard;
 	}
 
-	return word_list;
-}
+private:
+	static uint32_t bit(const char c) { return 1u << (c - detail::letter_a); }
 
-/*
-1. If we find a correct letter, remove:
-	- every candidate that does not have that letter in that position
-*/
-void green_filter(std::vector<string_t>& candidates, const char c, const size_t position)
-{
-	candidates.erase(std::remove_if(candidates.begin(),
-		candidates.end(),
-		[c, position](string_t x) { return x[position] != c; }),
-		candidates.end());
-}
+	std::array<char, length> green{};
+	std::array<uint32_t, length> excluded{};
+	uint32_t required = 0;
+	uint32_t absent = 0;
 
-/*
-2. If we find a letter that is used, but in a different position, remove:
-	- every candidate that uses that letter in that position, and
-	- every candidate that does not use that letter
-*/
-void yellow_filter(std::vector<string_t>& candidates, const char c, const size_t position)
-{
-	candidates.erase(std::remove_if(candidates.begin(),
-		candidates.end(),
-		[c, position](string_t x) { return !contains(x, c) || x[position] == c; }),
-		candidates.end());
-}
+	// How many times the answer uses each letter of counted, at least and at most.
+	uint32_t counted = 0;
+	std::array<uint8_t, 26> min_count{};
+	std::array<uint8_t, 26> max_count = filled_counts(uint8_t(length));
 
-/*
-3. If we find a letter that is not used, remove:
-	- every candidate that contains that letter
-*/
-void grey_filter(std::vector<string_t>& candidates, const char c)
-{
-	candidates.erase(std::remove_if(candidates.begin(),
-		candidates.end(),
-		[c](string_t x) { return contains(x, c); }),
-		candidates.end());
-}
+	static std::array<uint8_t, 26> filled_counts(const uint8_t n)
+	{
+		std::array<uint8_t, 26> counts;
+		counts.fill(n);
+		return counts;
+	}
+};
 
-string_t select_guess(const std::vector<string_t>& candidates, const std::vector<string_t>& dictionary)
+template<size_t length>
+word_t<length> select_guess(const std::vector<word_t<length>>& candidates, const std::vector<word_t<length>>& dictionary)
 {
 	std::vector<size_t> letter_weights(detail::letter_z + 1, 0);
 
 	// count how many words contain each letter (each letter only counted once per word)
 	for (const auto& word : candidates)
 	{
-		for (auto i = 0; i < word.size(); ++i)
+		for (size_t i = 0; i < length; ++i)
 		{
 			size_t score = 1;
 
 			// check letter against all previous letters
-			for (auto j = 0; j < i; ++j)
+			for (size_t j = 0; j < i; ++j)
 				if (word[i] == word[j])
 					score = 0;
 
@@ -174,14 +254,14 @@ string_t select_guess(const std::vector<string_t>& candidates, const std::vector
 
 	// find the word in the dictionary with the best score
 	size_t best_weight = 0;
-	string_t best_word = candidates[0]; // worst-case scenario, at least we pick a word from the list of candidates
+	word_t<length> best_word = candidates[0]; // worst-case scenario, at least we pick a word from the list of candidates
 	for (const auto& word : dictionary)
 	{
 		bool letters[26]{}; // array of false
 
 		// score the word
 		size_t weight = 0;
-		for (auto i = 0; i < word.size(); ++i)
+		for (size_t i = 0; i < length; ++i)
 		{
 			// skip if this letter has been scored
 			if (letters[word[i] - detail::letter_a]) continue;
@@ -203,19 +283,96 @@ string_t select_guess(const std::vector<string_t>& candidates, const std::vector
 	return best_word;
 }
 
-std::map<size_t, string_t> select_guesses(const std::vector<string_t>& candidates, const std::vector<string_t>& wordlist)
+/*
+select_guess(), with each candidate weighted by its prior (aligned with candidates) of being the answer. The
+weighted letter sums are built in the same pass as the plain letter counts: each word's letters become a bitmask,
+and every letter's count and weight are updated from it branch-free.
+*/
+template<size_t length>
+word_t<length> select_guess(const std::vector<word_t<length>>& candidates, const std::vector<float>& priors, const std::vector<word_t<length>>& dictionary)
+{
+	std::array<uint32_t, 26> letter_counts{};
+	std::array<float, 26> letter_weights{};
+	float total_weight = 0;
+
+	for (size_t w = 0; w < candidates.size(); ++w)
+	{
+		uint32_t letters = 0;
+		for (size_t i = 0; i < length; ++i)
+			letters |= 1u << (candidates[w][i] - detail::letter_a);
+
+		for (size_t c = 0; c < 26; ++c)
+		{
+			const uint32_t used = (letters >> c) & 1;
+			letter_counts[c] += used;
+			letter_weights[c] += used * priors[w];
+		}
+
+		total_weight += priors[w];
+	}
+
+	// As in select_guess(), but by weight. A letter that every candidate (or none) uses still tells us nothing.
+	for (size_t c = 0; c < 26; ++c)
+		letter_weights[c] = (letter_counts[c] == 0 || letter_counts[c] == candidates.size()) ?
+			0.0f :
+			std::min(letter_weights[c], total_weight - letter_weights[c]);
+
+	// find the word in the dictionary with the best score
+	float best_weight = 0;
+	word_t<length> best_word = candidates[0]; // worst-case scenario, at least we pick a word from the list of candidates
+	for (const auto& word : dictionary)
+	{
+		bool letters[26]{}; // array of false
+
+		// score the word
+		float weight = 0;
+		for (size_t i = 0; i < length; ++i)
+		{
+			// skip if this letter has been scored
+			if (letters[word[i] - detail::letter_a]) continue;
+
+			// note that we have scored this letter
+			letters[word[i] - detail::letter_a] = true;
+
+			weight += letter_weights[word[i] - detail::letter_a];
+		}
+
+		if (weight > best_weight)
+		{
+			best_weight = weight;
+			best_word = word;
+		}
+	}
+
+	return best_word;
+}
+
+// A guess, and how much select_guesses() expects it to tell us: higher is better.
+template<size_t length>
+struct Scored_guess
+{
+	size_t score = 0;
+	word_t<length> word;
+};
+
+/*
+Every word of the word list that would tell us something about the candidates, with its score, best first. Words
+with equal scores stay in word list order.
+*/
+template<size_t length>
+std::vector<Scored_guess<length>> select_guesses(const std::vector<word_t<length>>& candidates, const std::vector<word_t<length>>& wordlist)
 {
 	std::vector<size_t> letter_weights(detail::letter_z + 1, 0);
 
 	// count how many words contain each letter (each letter only counted once per word)
 	for (const auto& word : candidates)
 	{
-		for (auto i = 0; i < word.size(); ++i)
+		for (size_t i = 0; i < length; ++i)
 		{
 			size_t score = 1;
 
 			// check letter against all previous letters
-			for (auto j = 0; j < i; ++j)
+			for (size_t j = 0; j < i; ++j)
 				if (word[i] == word[j])
 					score = 0;
 
@@ -230,11 +387,7 @@ std::map<size_t, string_t> select_guesses(const std::vector<string_t>& candidate
 	for (auto& w : letter_weights)
 		w = std::min(w, candidates.size() - w);
 
-	// find the word in the dictionary with the best score
-	size_t best_weight = 0;
-	string_t best_word = candidates[0]; // worst-case scenario, at least we pick a word from the list of candidates
-
-	std::map<size_t, string_t> solutions;
+	std::vector<Scored_guess<length>> solutions;
 
 	for (const auto& word : wordlist)
 	{
@@ -243,7 +396,7 @@ std::map<size_t, string_t> select_guesses(const std::vector<string_t>& candidate
 		// score the word
 		size_t weight = 0;
 
-		for (auto i = 0; i < word.size(); ++i)
+		for (size_t i = 0; i < length; ++i)
 		{
 			// skip if this letter has been scored
 			if (letters[word[i] - detail::letter_a]) continue;
@@ -256,101 +409,248 @@ std::map<size_t, string_t> select_guesses(const std::vector<string_t>& candidate
 
 		if (weight > 0)
 		{
-			solutions.insert({ weight, word });
+			solutions.push_back({ weight, word });
 		}
 	}
 
+	std::stable_sort(solutions.begin(), solutions.end(),
+		[](const Scored_guess<length>& a, const Scored_guess<length>& b) { return a.score > b.score; });
+
 	return solutions;
 }
 
-void play(const std::vector<string_t>& dictionary, const string_t& answer, const string_t& first_guess = "")
+/*
+Pick the guess whose pattern distribution has the most entropy, with each candidate weighted by its prior
+(aligned with candidates), and the guess list split across the threads of the pool. 5-letter words have an
+overload of their own, in histogram_engine.hpp, where the pattern kernel works out each guess's patterns instead of
+get_pattern().
+*/
+template<size_t length>
+word_t<length> select_guess_entropy(const std::vector<word_t<length>>& candidates, const std::vector<float>& priors, const std::vector<word_t<length>>& dictionary,
+	Thread_pool& pool)
+{
+	if (candidates.size() == 1) return candidates[0];
+
+	double total_weight = 0;
+	for (const float prior : priors)
+		total_weight += prior;
+
+	std::vector<Best_guess> best(pool.size());
+
+	pool.parallel_for(dictionary.size(), [&](const size_t begin, const size_t end, const size_t thread)
+		{
+			std::vector<float> weights(detail::pattern_count(length));
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				std::fill(weights.begin(), weights.end(), 0.0f);
+				for (size_t w = 0; w < candidates.size(); ++w)
+					weights[get_pattern(dictionary[i], candidates[w])] += priors[w];
+
+				best[thread].offer(weighted_entropy_score(weights, total_weight), i);
+			}
+		});
+
+	return dictionary[Best_guess::of(best)];
+}
+
+/*
+The unweighted entropy selector: every candidate is equally likely. 5-letter words have an overload of their own,
+in histogram_engine.hpp, which the histogram engine makes ten times faster.
+*/
+template<size_t length>
+word_t<length> select_guess_entropy(const std::vector<word_t<length>>& candidates, const std::vector<word_t<length>>& dictionary, Thread_pool& pool)
+{
+	// one candidate's a sure win, and of two, the first wins half the time, as well as any split
+	if (!candidates.empty() && candidates.size() <= 2) return candidates[0];
+
+	return select_guess_entropy<length>(candidates, std::vector<float>(candidates.size(), 1.0f), dictionary, pool);
+}
+
+/*
+Keep the candidates that would have given this guess the same pattern as the answer did. This is the exact
+feedback that the selectors which score guesses by their patterns (by entropy, across several boards, or looking
+ahead) expect, repeated letters included.
+*/
+template<size_t length>
+void filter_by_pattern(std::vector<word_t<length>>& candidates, const word_t<length>& guess, const word_t<length>& answer)
+{
+	const uint32_t pattern = get_pattern(guess, answer);
+	candidates.erase(std::remove_if(candidates.begin(),
+		candidates.end(),
+		[&guess, pattern](const word_t<length>& x) { return get_pattern(guess, x) != pattern; }),
+		candidates.end());
+}
+
+/*
+Play one game. In hard mode, every guess must use the hints revealed so far, so we keep a second list of the
+guesses that are still legal, and filter it alongside the candidates.
+
+If priors are given (one per dictionary word), candidates are weighted by them, and the priors are filtered
+alongside the candidates so they stay aligned.
+
+Given an entropy_pool, guesses are picked by select_guess_entropy() on its threads, instead of by select_guess(). It
+scores guesses by the exact patterns they would get, so the candidates are filtered by the exact pattern too.
+
+Returns how the game went: the number of guesses, and the candidates and time taken on each turn.
+*/
+template<size_t length>
+Game_result play(const std::vector<word_t<length>>& dictionary, const word_t<length>& answer, const word_t<length>& first_guess = "",
+	const bool hard_mode = false, const std::vector<float>& priors = {}, Thread_pool* const entropy_pool = nullptr)
 {
-	std::vector<string_t> candidates = dictionary; // mutable copy for thinkin'
+	std::vector<word_t<length>> candidates = dictionary; // mutable copy for thinkin'
+	std::vector<word_t<length>> legal_guesses = hard_mode ? dictionary : std::vector<word_t<length>>{};
+	std::vector<float> candidate_priors = priors;
+	const bool weighted = !priors.empty();
+
+	Game_record record;
+	if constexpr (detail::tracing) record.set_answer(answer);
+
+	Game_result result;
 
 	// std::cout << "\n\n" << answer << "\n\t\tGreen:\tYellow:\tGrey:\n";
 
-	for (auto guess_n = 0; guess_n < 6; ++guess_n)
+	for (size_t guess_n = 0; guess_n < detail::max_turns; ++guess_n)
 	{
-		const string_t guess = (guess_n == 0 && !first_guess.empty()) ?
+		const auto turn_start = current_time_in_us();
+		result.candidates[guess_n] = uint32_t(candidates.size());
+		result.turns = guess_n + 1;
+
+		const std::vector<word_t<length>>& guesses = hard_mode ? legal_guesses : dictionary;
+		const word_t<length> guess = (guess_n == 0 && !first_guess.empty()) ?
 			first_guess :
-			select_guess(candidates, dictionary);
+			entropy_pool ?
+			(weighted ? select_guess_entropy(candidates, candidate_priors, guesses, *entropy_pool) : select_guess_entropy(candidates, guesses, *entropy_pool)) :
+			(weighted ? select_guess(candidates, candidate_priors, guesses) : select_guess(candidates, guesses));
 
 		// std::cout << "Guess " << (guess_n + 1) << ": " << guess << '\t';
 
+		if constexpr (detail::tracing) record.add_turn(guess, get_pattern(guess, answer), candidates.size());
+
 		if (guess == answer)
 		{
 			// std::cout << "Correct!" << std::endl;
-			return;
-		}
-
-		// check for matching letters
-		for (auto i = 0; i < guess.size(); ++i)
-		{
-			if (guess[i] == answer[i])
+			if constexpr (detail::tracing)
 			{
-				// std::cout << guess[i];
-
-				green_filter(candidates, guess[i], i);
-			}
-			else
-			{
-				// std::cout << '.';
+				record.won = 1;
+				trace_game(record);
 			}
+			result.turn_time_us[guess_n] = current_time_in_us() - turn_start;
+			result.guesses = guess_n + 1;
+			return result;
 		}
 
-		// std::cout << '\t';
+		Constraints<length> hints;
+		if (entropy_pool)
+			hints.add_pattern(guess, get_pattern(guess, answer));
+		else
+			hints.add_feedback(guess, answer);
+		if (weighted)
+			hints.filter(candidates, candidate_priors);
+		else
+			hints.filter(candidates);
 
-		// check for right letter, wrong place
-		for (auto i = 0; i < guess.size(); ++i)
-		{
-			if (guess[i] != answer[i] && contains(answer, guess[i]))
-			{
-				// std::cout << guess[i];
+		if (hard_mode)
+			hints.hard_mode().filter(legal_guesses);
 
-				yellow_filter(candidates, guess[i], i);
-			}
-			else
-			{
-				// std::cout << '.';
-			}
-		}
+		result.turn_time_us[guess_n] = current_time_in_us() - turn_start;
+	}
 
-		// check for unused letter
-		for (auto i = 0; i < guess.size(); ++i)
-		{
-			if (!contains(answer, guess[i]))
-			{
-				// std::cout << guess[i];
+	if constexpr (detail::tracing) trace_game(record);
 
-				grey_filter(candidates, guess[i]);
-			}
-			else
+	result.candidates_left = candidates.size();
+	return result;
+}
+
+/*
+Play every word of the dictionary as the answer, and gather how the games went, without printing anything.
+
+The games are played one at a time, as every time in optimization notes.txt was measured. With parallel, they
+are spread across threads instead, each with its own stats, merged once every game is done. With entropy, each
+guess is already spread across the threads of a pool, started once for the whole sweep, so the games are always
+played one at a time.
+*/
+template<size_t length>
+Test_stats sweep(const std::vector<word_t<length>>& dictionary, const bool hard_mode = false, const std::vector<float>& priors = {},
+	const bool entropy = false, const bool parallel = false)
+{
+	const std::unique_ptr<Thread_pool> entropy_pool = entropy ? std::make_unique<Thread_pool>() : nullptr;
+
+	// The first guess of every round is deterministic. Calculate it once, here.
+	const word_t<length> first_guess = entropy ?
+		(priors.empty() ? select_guess_entropy(dictionary, dictionary, *entropy_pool) : select_guess_entropy(dictionary, priors, dictionary, *entropy_pool)) :
+		(priors.empty() ? select_guess(dictionary, dictionary) : select_guess(dictionary, priors, dictionary));
+
+	if (!parallel || entropy)
+	{
+		Test_stats stats;
+		for (size_t i = 0; i < dictionary.size(); ++i)
+			stats.add(i, std::string(dictionary[i].data(), length), play(dictionary, dictionary[i], first_guess, hard_mode, priors, entropy_pool.get()));
+		return stats;
+	}
+
+	std::vector<Test_stats> thread_stats(thread_count());
+	parallel_for(dictionary.size(), [&](const size_t begin, const size_t end, const size_t thread)
+		{
+			for (size_t i = begin; i < end; ++i)
 			{
-				// std::cout << '.';
+				const Game_result result = play(dictionary, dictionary[i], first_guess, hard_mode, priors);
+				thread_stats[thread].add(i, std::string(dictionary[i].data(), length), result);
 			}
-		}
-	}
+		});
 
-	std::cout << "Lost on " << answer << ", " << candidates.size() << " candidates left.\n";
+	Test_stats stats;
+	for (const auto& s : thread_stats)
+		stats.merge(s);
+	stats.set_threads(thread_stats.size());
+	return stats;
 }
 
-void test()
+template<size_t length>
+void test(const std::vector<word_t<length>>& dictionary, const bool hard_mode = false, const std::vector<float>& priors = {},
+	const bool entropy = false, const bool parallel = false)
 {
-	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+	std::cout << "Loaded " << dictionary.size() << " words" << (hard_mode ? ", playing in hard mode" : "")
+		<< (entropy ? ", picking guesses by entropy." : ".") << std::endl;
 
-	std::cout << "Loaded " << dictionary.size() << " words." << std::endl;
+	if constexpr (detail::tracing) open_trace();
 
 	const auto start_time = current_time_in_us();
 
-	// The first guess of every round is deterministic. Calculate it once, here.
-	const string_t first_guess = select_guess(dictionary, dictionary);
-
-	for (auto i = 0; i < dictionary.size(); ++i)
-	{
-		play(dictionary, dictionary[i], first_guess);
-	}
+	const Test_stats stats = sweep(dictionary, hard_mode, priors, entropy, parallel);
 
 	const auto elapsed_time = current_time_in_us() - start_time;
 
-	std::cout << "\nPlayed " << dictionary.size() << " games, " << elapsed_time / 1'000 << " ms elapsed (" << (elapsed_time / dictionary.size()) << " us per game)\n";
+	if constexpr (detail::tracing) close_trace();
+
+	for (const auto& game : stats.lost_games())
+		std::cout << "Lost on " << game.answer << ", " << game.result.candidates_left << " candidates left.\n";
+
+	// Times on several threads aren't comparable with the single-threaded ones, so they say how many there were.
+	std::cout << "\nPlayed " << dictionary.size() << " games";
+	if (stats.threads() > 1)
+		std::cout << " on " << stats.threads() << " threads";
+	std::cout << ", " << elapsed_time / 1'000 << " ms elapsed (" << (elapsed_time / dictionary.size()) << " us per game)\n\n";
+
+	stats.print(std::cout);
+
+	if (stats.write_json(detail::stats_filename))
+		std::cout << "\nWrote " << detail::stats_filename << '\n';
+}
+
+void test(const bool hard_mode = false, const bool parallel = false)
+{
+	test(load_wordle_nyt_words(), hard_mode, {}, false, parallel);
+}
+
+// Run the benchmark on a word list of any supported length.
+void test(const size_t word_length, const std::string& filename, const bool hard_mode = false, const bool parallel = false)
+{
+	const bool supported = dispatch_word_length(word_length, [&](auto length)
+		{
+			test(load_wordlist<decltype(length)::value>(filename), hard_mode, {}, false, parallel);
+		});
+
+	if (!supported)
+		std::cout << "Unsupported word length: " << word_length << '\n';
 }
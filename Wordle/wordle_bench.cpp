@@ -0,0 +1,202 @@
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "histogram_engine.hpp"
+#include "pattern_kernel.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+#include "wordle.hpp"
+
+/*
+The benchmark suite: the sweep of test(), in normal and hard mode, and the pattern kernel and histogram engine on
+their own. The sweeps time sweep() alone, as test() does: the word list is loaded before, and nothing is printed
+or written during. Each benchmark's time is written to a JSON file along with the compiler and the build's
+flags, so builds can be compared. Given the JSON of another build as a baseline, each benchmark's
+speedup over it is written too. With --repeat, each benchmark runs that many times and the fastest run counts,
+which takes out most of the noise of a busy machine.
+*/
+
+#ifndef WORDLE_BUILD
+#define WORDLE_BUILD "unknown"
+#endif
+
+namespace detail
+{
+	constexpr char bench_filename[] = "wordle_bench.json";
+
+#if defined(__clang__)
+	const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+	const std::string compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+	const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+	const std::string compiler = "unknown";
+#endif
+}
+
+// A benchmark returns a checksum of its work, which is printed after it's timed, and keeps the work from being optimized away.
+struct Benchmark
+{
+	std::string name;
+	std::function<size_t()> run;
+};
+
+struct Bench_result
+{
+	std::string name;
+	int64_t us = 0;
+};
+
+std::vector<Benchmark> benchmarks(const std::vector<string_t>& dictionary, Thread_pool& pool)
+{
+	return {
+		{ "sweep", [&dictionary] { return sweep(dictionary).wins(); } },
+		{ "sweep_hard", [&dictionary] { return sweep(dictionary, true).wins(); } },
+		{ "kernel", [&dictionary]
+			{
+				// every guess against every answer, one thread
+				const Answer_block block{ dictionary };
+				std::vector<uint8_t> patterns(block.padded_size());
+				size_t checksum = 0;
+				for (const auto& guess : dictionary)
+				{
+					compute_patterns(guess, block, patterns.data());
+					checksum += patterns[0];
+				}
+				return checksum;
+			} },
+		{ "histogram", [&dictionary, &pool]
+			{
+				const Answer_block block{ dictionary };
+				std::atomic<size_t> total{ 0 };
+				for_each_histogram(dictionary, block, pool, [&](const size_t, const histogram_t& histogram) { total += histogram[0]; });
+				return total.load();
+			} },
+	};
+}
+
+// The times in a file written by write_bench_json(), in ms, by benchmark name. It has one benchmark per line.
+std::map<std::string, double> load_bench_times(const std::string& filename)
+{
+	const std::string name_key = "\"name\": \"", ms_key = "\"ms\": ";
+
+	std::map<std::string, double> times;
+	std::ifstream in{ filename };
+	std::string line;
+	while (std::getline(in, line))
+	{
+		const size_t name = line.find(name_key), ms = line.find(ms_key);
+		if (name == std::string::npos || ms == std::string::npos) continue;
+
+		const size_t name_begin = name + name_key.size();
+		times[line.substr(name_begin, line.find('"', name_begin) - name_begin)] = std::stod(line.substr(ms + ms_key.size()));
+	}
+	return times;
+}
+
+void write_bench_json(std::ostream& out, const std::vector<Bench_result>& results,
+	const std::string& baseline_filename = {}, const std::map<std::string, double>& baseline = {})
+{
+	out << "{\n\t\"build\": \"" << WORDLE_BUILD << "\",\n\t\"compiler\": \"" << detail::compiler
+		<< "\",\n\t\"threads\": " << thread_count() << ",\n";
+	if (!baseline_filename.empty())
+		out << "\t\"baseline\": \"" << baseline_filename << "\",\n";
+	out << "\t\"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const double ms = double(results[i].us) / 1'000;
+		out << (i ? "," : "") << "\n\t\t{ \"name\": \"" << results[i].name << "\", \"ms\": " << ms;
+
+		const auto it = baseline.find(results[i].name);
+		if (it != baseline.end())
+			out << ", \"baseline_ms\": " << it->second << ", \"speedup\": " << it->second / std::max(ms, 0.001);
+		out << " }";
+	}
+	out << "\n\t]\n}\n";
+}
+
+// Usage: wordle_bench [--words <directory>] [--output <file>] [--baseline <file>] [--repeat <n>] [benchmark]...
+int main(int argc, char** argv)
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+	std::string output = detail::bench_filename;
+	std::string baseline_filename;
+	size_t repeat = 1;
+	std::vector<std::string> selected;
+
+	for (size_t i = 0; i < args.size(); ++i)
+	{
+		if (args[i] == "--words" && i + 1 < args.size())
+			set_word_list_directory(args[++i]);
+		else if (args[i] == "--output" && i + 1 < args.size())
+			output = args[++i];
+		else if (args[i] == "--baseline" && i + 1 < args.size())
+			baseline_filename = args[++i];
+		else if (args[i] == "--repeat" && i + 1 < args.size())
+			repeat = std::max<size_t>(1, std::stoull(args[++i]));
+		else
+			selected.push_back(args[i]);
+	}
+
+	const std::vector<string_t> dictionary = load_wordle_nyt_words();
+	if (dictionary.empty())
+	{
+		std::cout << "Could not load wordle_nyt.txt from " << detail::word_list_directory() << " (set it with --words)\n";
+		return EXIT_FAILURE;
+	}
+
+	Thread_pool pool; // its threads start here, outside the timing
+	std::vector<Bench_result> results;
+	for (const Benchmark& benchmark : benchmarks(dictionary, pool))
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), benchmark.name) == selected.end())
+			continue;
+
+		int64_t fastest = std::numeric_limits<int64_t>::max();
+		for (size_t run = 0; run < repeat; ++run)
+		{
+			const auto start_time = current_time_in_us();
+			const size_t checksum = benchmark.run();
+			const int64_t elapsed = current_time_in_us() - start_time;
+			fastest = std::min(fastest, elapsed);
+
+			std::cout << benchmark.name << ": " << elapsed / 1'000 << " ms (checksum " << checksum << ")\n";
+		}
+		results.push_back({ benchmark.name, fastest });
+	}
+
+	const std::map<std::string, double> baseline = baseline_filename.empty() ? std::map<std::string, double>{} : load_bench_times(baseline_filename);
+	if (!baseline_filename.empty() && baseline.empty())
+		std::cout << "No benchmark times in " << baseline_filename << '\n';
+
+	std::cout << '\n';
+	for (const Bench_result& result : results)
+	{
+		std::cout << result.name << ": " << result.us / 1'000 << " ms";
+		const auto it = baseline.find(result.name);
+		if (it != baseline.end())
+			std::cout << " (" << it->second / std::max(double(result.us) / 1'000, 0.001) << "x the baseline's speed)";
+		std::cout << '\n';
+	}
+
+	std::ofstream out{ output };
+	write_bench_json(out, results, baseline_filename, baseline);
+	if (!out)
+	{
+		std::cout << "Could not write " << output << '\n';
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Wrote " << output << '\n';
+	return EXIT_SUCCESS;
+}
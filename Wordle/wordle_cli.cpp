@@ -0,0 +1,211 @@
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absurdle.hpp"
+#include "corpus_loader.hpp"
+#include "histogram_engine.hpp"
+#include "lookahead.hpp"
+#include "multi_board.hpp"
+#include "pattern_kernel.hpp"
+#include "pattern_matrix.hpp"
+#include "priors.hpp"
+#include "shared_tables.hpp"
+#include "trace.hpp"
+#include "wordle.hpp"
+
+/*
+The solver without the GUI: the benchmarks and component tests, a headless solver, and trace diffs, chosen by
+the first argument.
+*/
+
+namespace detail
+{
+	constexpr size_t synthetic_guesses = 500;
+	constexpr size_t synthetic_answers = 3000;
+
+	constexpr size_t suggestions_shown = 10;
+}
+
+void print_usage()
+{
+	std::cout <<
+		"Usage: wordle_cli [--words <directory>] <command> [arguments]\n"
+		"\n"
+		"  test [--hard]                     play every word of wordle_nyt.txt as the answer\n"
+		"  test <length> <file> [--hard]     the same, for a word list of another length\n"
+		"                                    (test and priors take --parallel, to spread the games across threads)\n"
+		"  priors [--hard] [--entropy]       the same, weighting candidates by word frequency; with --entropy,\n"
+		"                                    picking guesses by weighted entropy, each spread across every thread\n"
+		"  lookahead [games] [beam] [depth]  play with beam-search lookahead\n"
+		"  absurdle [beam]                   play Absurdle\n"
+		"  multi <boards> <games>            play several boards at once\n"
+		"  solve [<guess> <pattern>]...      candidates and guesses for these hints; a pattern is G, Y or - per letter\n"
+		"  diff <before> <after>             compare two traces game by game\n"
+		"  verify-kernel [seed]              check the pattern kernel against get_pattern() on random words\n"
+		"  kernel | histogram | matrix | shared | loader\n"
+		"                                    benchmark one component\n";
+}
+
+/*
+Words that exercise the kernel's corner cases: most are drawn from a few letters, so repeated letters, and
+repeated letters in both guess and answer, are common.
+*/
+std::vector<string_t> synthetic_words(const size_t count, std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> common(0, 5), any(0, 25), coin(0, 3);
+
+	std::vector<string_t> words;
+	for (size_t i = 0; i < count; ++i)
+	{
+		string_t word;
+		for (size_t j = 0; j < detail::word_length; ++j)
+			word.push_back(char(detail::letter_a + (coin(rng) ? common(rng) : any(rng))));
+		words.push_back(word);
+	}
+	return words;
+}
+
+int verify_kernel(const uint32_t seed)
+{
+	std::mt19937 rng{ seed };
+	const std::vector<string_t> guesses = synthetic_words(detail::synthetic_guesses, rng);
+
+	// An answer count that isn't a whole number of vectors, so the padded tail is covered too.
+	const std::vector<string_t> answers = synthetic_words(detail::synthetic_answers + 7, rng);
+
+	const size_t mismatches = verify_pattern_kernel(guesses, answers);
+	std::cout << "Checked " << guesses.size() << " guesses against " << answers.size() << " answers (seed " << seed << "): "
+		<< mismatches << " mismatches.\n";
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Filter wordle_nyt.txt by the hints, as the GUI does, and show what's left and what to guess next.
+int solve(const std::vector<std::string>& hints)
+{
+	const std::vector<string_t> words = load_wordle_nyt_words();
+
+	Constraints<detail::word_length> constraints;
+	for (size_t i = 0; i + 1 < hints.size(); i += 2)
+	{
+		std::string guess = hints[i];
+		const std::string& pattern = hints[i + 1];
+		transform(guess.begin(), guess.end(), guess.begin(), ::toupper);
+
+		if (guess.size() != detail::word_length || pattern.size() != detail::word_length)
+		{
+			std::cout << "Expected a " << detail::word_length << "-letter guess and pattern, got " << guess << ' ' << pattern << '\n';
+			return EXIT_FAILURE;
+		}
+
+		uint32_t digits = 0;
+		for (size_t j = detail::word_length; j-- > 0;)
+		{
+			const char mark = char(::toupper(pattern[j]));
+			digits = digits * 3 + (mark == 'G' ? 2 : mark == 'Y' ? 1 : 0);
+		}
+		constraints.add_pattern(string_t(guess), digits);
+	}
+
+	std::vector<string_t> candidates = words;
+	constraints.filter(candidates);
+
+	std::cout << candidates.size() << (candidates.size() == 1 ? " candidate" : " candidates") << ":\n";
+	for (size_t i = 0; i < candidates.size() && i < 100; ++i)
+		std::cout << "  " << candidates[i] << '\n';
+	if (candidates.size() > 100)
+		std::cout << "  ...\n";
+
+	if (candidates.size() > 2)
+	{
+		Thread_pool pool;
+		const ranked_guesses_t ranked = rank_guesses_by_entropy(candidates, words, pool);
+		std::cout << "\nBest guesses by entropy, in bits:\n";
+		for (size_t i = 0; i < ranked.size() && i < detail::suggestions_shown; ++i)
+			std::cout << "  " << ranked[i].second << "  " << ranked[i].first << '\n';
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	if (args.size() >= 2 && args[0] == "--words")
+	{
+		set_word_list_directory(args[1]);
+		args.erase(args.begin(), args.begin() + 2);
+	}
+
+	if (args.empty())
+	{
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	const std::string command = args[0];
+	// Remove a flag from the arguments, wherever it is, and return whether it was there.
+	const auto take_flag = [&args](const std::string& flag)
+	{
+		const auto it = std::find(args.begin() + 1, args.end(), flag);
+		if (it == args.end()) return false;
+		args.erase(it);
+		return true;
+	};
+
+	const bool hard_mode = take_flag("--hard");
+	const bool entropy = take_flag("--entropy");
+	const bool parallel = take_flag("--parallel");
+
+	const auto number = [&args](const size_t i, const size_t otherwise)
+	{
+		return i < args.size() ? size_t(std::stoull(args[i])) : otherwise;
+	};
+
+	// Everything but the kernel check and trace diffs needs the word list.
+	if (command != "verify-kernel" && command != "diff" && !(command == "test" && args.size() == 3) && load_wordle_nyt_words().empty())
+	{
+		std::cout << "Could not load wordle_nyt.txt from " << detail::word_list_directory() << " (set it with --words)\n";
+		return EXIT_FAILURE;
+	}
+
+	if (command == "test" && args.size() == 3)
+		test(number(1, detail::word_length), args[2], hard_mode, parallel);
+	else if (command == "test")
+		test(hard_mode, parallel);
+	else if (command == "priors")
+		test_with_priors(hard_mode, entropy, parallel);
+	else if (command == "lookahead")
+		test_lookahead(number(1, 100), number(2, detail::lookahead_beam_width), number(3, detail::lookahead_depth));
+	else if (command == "absurdle")
+		test_absurdle(number(1, detail::absurdle_beam_width));
+	else if (command == "multi" && args.size() == 3)
+		test_multi(number(1, 2), number(2, 100));
+	else if (command == "solve")
+		return solve({ args.begin() + 1, args.end() });
+	else if (command == "diff" && args.size() == 3)
+		diff_traces(args[1], args[2]);
+	else if (command == "verify-kernel")
+		return verify_kernel(uint32_t(number(1, 1)));
+	else if (command == "kernel")
+		test_pattern_kernel();
+	else if (command == "histogram")
+		test_histogram_engine();
+	else if (command == "matrix")
+		test_pattern_matrix();
+	else if (command == "shared")
+		test_shared_tables();
+	else if (command == "loader")
+		test_loader();
+	else
+	{
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
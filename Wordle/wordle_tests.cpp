@@ -0,0 +1,478 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "corpus_loader.hpp"
+#include "histogram_engine.hpp"
+#include "packed_board.hpp"
+#include "stats.hpp"
+#include "word_set.hpp"
+#include "wordle.hpp"
+
+/*
+Behavioural tests, one per ctest entry: wordle_tests <test>, or every test with no argument. Each checks a
+component against a plain model of what it should do, on fixed cases and on random words, and prints every check
+that failed. Nothing here reads the word lists, so the tests run anywhere.
+*/
+
+namespace detail
+{
+	constexpr size_t random_games = 2000;
+	constexpr size_t random_words = 400;
+	constexpr size_t max_rows_tested = 4;
+	constexpr size_t corpus_lines = 20000; // enough for every loader thread to get several chunks
+	constexpr size_t test_threads = 3; // pools get more than one thread, even on one core
+}
+
+size_t failures = 0;
+
+void check(const bool passed, const std::string& what)
+{
+	if (passed) return;
+	++failures;
+	std::cout << "Failed: " << what << '\n';
+}
+
+/*
+Random words, mostly from the first few letters of the alphabet, so that repeated letters, in the guess and the
+answer both, are common.
+*/
+std::vector<string_t> random_words(const size_t count, std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> common(0, 4), any(0, 25), coin(0, 4);
+
+	std::vector<string_t> words;
+	for (size_t i = 0; i < count; ++i)
+	{
+		string_t word;
+		for (size_t j = 0; j < detail::word_length; ++j)
+			word.push_back(char(detail::letter_a + (coin(rng) ? common(rng) : any(rng))));
+		words.push_back(word);
+	}
+	return words;
+}
+
+// A pattern written as the solve command takes it: G, Y or - per letter.
+uint32_t pattern_from_marks(const std::string& marks)
+{
+	uint32_t pattern = 0;
+	for (size_t i = marks.size(); i-- > 0;)
+		pattern = pattern * 3 + (marks[i] == 'G' ? 2 : marks[i] == 'Y' ? 1 : 0);
+	return pattern;
+}
+
+/*
+Constraints built from rows of feedback must allow exactly the words that would have given every row's guess
+the same pattern, repeated letters included, whether the rows are added directly or through a Packed_board.
+*/
+void test_constraints()
+{
+	// SPEED against ABIDE: one E is yellow, and the other grey because ABIDE has only one.
+	const string_t speed = "SPEED", abide = "ABIDE";
+	check(get_pattern(speed, abide) == pattern_from_marks("--Y-Y"), "SPEED against ABIDE is --Y-Y");
+
+	Constraints<detail::word_length> hints;
+	hints.add_pattern(speed, pattern_from_marks("--Y-Y"));
+	check(hints.allows(abide), "SPEED --Y-Y allows ABIDE");
+	check(!hints.allows("ELIDE"), "SPEED --Y-Y rules out ELIDE, which has two Es");
+
+	// EERIE against THEME: a yellow, a grey and a green E, so the answer has exactly two, one of them last
+	const string_t eerie = "EERIE";
+	check(get_pattern(eerie, string_t("THEME")) == pattern_from_marks("Y---G"), "EERIE against THEME is Y---G");
+
+	Constraints<detail::word_length> two_es;
+	two_es.add_pattern(eerie, pattern_from_marks("Y---G"));
+	check(two_es.allows("THEME"), "EERIE Y---G allows THEME");
+	check(two_es.allows("SCENE"), "EERIE Y---G allows SCENE");
+	check(!two_es.allows("TEPEE"), "EERIE Y---G rules out TEPEE, which has three Es");
+	check(!two_es.allows("SHAME"), "EERIE Y---G rules out SHAME, which has one E");
+	check(!two_es.allows("ELATE"), "EERIE Y---G rules out ELATE, which starts with an E");
+
+	std::mt19937 rng{ 1 };
+	const std::vector<string_t> words = random_words(detail::random_words, rng);
+	std::uniform_int_distribution<size_t> pick(0, words.size() - 1), rows(1, detail::max_rows_tested);
+
+	size_t mismatches = 0;
+	for (size_t game = 0; game < detail::random_games; ++game)
+	{
+		const string_t& answer = words[pick(rng)];
+		std::vector<string_t> guesses(rows(rng));
+		for (auto& guess : guesses)
+			guess = words[pick(rng)];
+
+		Constraints<detail::word_length> constraints;
+		Packed_board<detail::max_rows_tested, detail::word_length> board;
+		for (size_t row = 0; row < guesses.size(); ++row)
+		{
+			const uint32_t pattern = get_pattern(guesses[row], answer);
+			constraints.add_pattern(guesses[row], pattern);
+
+			for (uint32_t column = 0, p = pattern; column < detail::word_length; ++column, p /= 3)
+			{
+				board.set_letter(row, column, guesses[row][column]);
+				board.set_color(row, column, p % 3);
+			}
+		}
+		const Constraints<detail::word_length> from_board = board.constraints();
+
+		for (const auto& word : words)
+		{
+			bool expected = true;
+			for (const auto& guess : guesses)
+				expected &= get_pattern(guess, word) == get_pattern(guess, answer);
+
+			if (constraints.allows(word) != expected || from_board.allows(word) != expected)
+			{
+				if (mismatches++ < 10)
+					std::cout << "Answer " << answer << ", word " << word << ": expected " << (expected ? "allowed" : "ruled out") << '\n';
+			}
+		}
+	}
+	check(mismatches == 0, std::to_string(mismatches) + " words judged differently from get_pattern()");
+}
+
+// The old one-hint-at-a-time filters, Constraints, and the hard mode subset of it, on the same hints.
+void test_filters()
+{
+	std::mt19937 rng{ 2 };
+	const std::vector<string_t> words = random_words(detail::random_words, rng);
+	std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+
+	size_t mismatches = 0, answers_lost = 0, hard_mismatches = 0;
+	for (size_t game = 0; game < detail::random_games / 4; ++game)
+	{
+		const string_t& answer = words[pick(rng)];
+		const string_t& guess = words[pick(rng)];
+
+		std::vector<string_t> filtered = words;
+		for (size_t i = 0; i < detail::word_length; ++i)
+		{
+			if (guess[i] == answer[i])
+				green_filter(filtered, guess[i], i);
+			else if (contains(answer, guess[i]))
+				yellow_filter(filtered, guess[i], i);
+			else
+				grey_filter(filtered, guess[i]);
+		}
+
+		Constraints<detail::word_length> hints;
+		hints.add_feedback(guess, answer);
+		std::vector<string_t> constrained = words;
+		hints.filter(constrained);
+
+		mismatches += filtered != constrained;
+		answers_lost += !hints.allows(answer);
+
+		// hard mode keeps greens in place and reuses yellows, and nothing else
+		const Constraints<detail::word_length> hard = hints.hard_mode();
+		for (const auto& word : words)
+		{
+			bool expected = true;
+			for (size_t i = 0; i < detail::word_length; ++i)
+			{
+				if (guess[i] == answer[i])
+					expected &= word[i] == guess[i];
+				else if (contains(answer, guess[i]))
+					expected &= contains(word, guess[i]);
+			}
+			hard_mismatches += hard.allows(word) != expected;
+		}
+	}
+	check(mismatches == 0, std::to_string(mismatches) + " games where Constraints and the per-hint filters disagree");
+	check(answers_lost == 0, std::to_string(answers_lost) + " games where the feedback rules out the answer");
+	check(hard_mismatches == 0, std::to_string(hard_mismatches) + " words judged wrongly by the hard mode constraints");
+
+	// filtering with values keeps them aligned with the words
+	const std::vector<string_t> few = { "ABIDE", "SPEED", "ABODE", "ERASE" };
+	std::vector<string_t> kept = few;
+	std::vector<size_t> values = { 0, 1, 2, 3 };
+	Constraints<detail::word_length> has_b;
+	has_b.add_green('B', 1);
+	has_b.filter(kept, values);
+	check(kept == std::vector<string_t>{ "ABIDE", "ABODE" } && values == std::vector<size_t>{ 0, 2 }, "filtering with values keeps them aligned");
+}
+
+// Packed codes round-trip and sort like words, and Word_set finds exactly the words it was given.
+void test_word_set()
+{
+	std::mt19937 rng{ 3 };
+	std::vector<string_t> words = random_words(detail::random_words, rng);
+	words.push_back(words[0]); // a duplicate, which the set keeps once
+
+	size_t round_trip_failures = 0, order_failures = 0;
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		round_trip_failures += unpack<detail::word_length>(pack(words[i])) != words[i];
+		if (i > 0) order_failures += (pack(words[i - 1]) < pack(words[i])) != (words[i - 1] < words[i]);
+	}
+	check(round_trip_failures == 0, "pack() and unpack() round-trip");
+	check(order_failures == 0, "packed codes sort as the words do");
+
+	const word_t<7> long_word = "ZYXWVUT";
+	check(unpack<7>(pack(long_word)) == long_word, "a 7-letter word round-trips through a 64-bit code");
+
+	std::vector<string_t> sorted = words;
+	std::sort(sorted.begin(), sorted.end());
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+	const Word_set<> set{ words };
+	check(set.size() == sorted.size(), "Word_set drops duplicates");
+
+	size_t index_failures = 0;
+	for (size_t i = 0; i < sorted.size(); ++i)
+		index_failures += set.index_of(sorted[i]) != i || set[i] != sorted[i];
+	check(index_failures == 0, "Word_set indexes words in sorted order");
+
+	size_t false_positives = 0;
+	for (const auto& word : random_words(detail::random_words, rng))
+		false_positives += set.contains(word) != std::binary_search(sorted.begin(), sorted.end(), word);
+	check(false_positives == 0, "Word_set::contains() agrees with a binary search");
+
+	const Word_set<> empty;
+	check(empty.empty() && !empty.contains("ABIDE") && empty.index_of("ABIDE") == Word_set<>::npos, "an empty Word_set contains nothing");
+}
+
+/*
+The loader against a plain line-by-line parse of the same file: words of other lengths and with other
+characters are skipped, case is folded, and the last line needn't end in a newline.
+*/
+void test_corpus_loader()
+{
+	std::mt19937 rng{ 4 };
+	std::uniform_int_distribution<int> letter(0, 25), length(3, 7), count(0, 1'000'000), odd(0, 19);
+
+	std::ostringstream corpus;
+	for (size_t line = 0; line < detail::corpus_lines; ++line)
+	{
+		std::string word(size_t(length(rng)), ' ');
+		for (char& c : word)
+			c = char((odd(rng) == 0 ? 'a' : 'A') + letter(rng));
+		if (odd(rng) == 0) word[0] = '-';
+
+		corpus << word << (odd(rng) == 0 ? ' ' : '\t') << count(rng);
+		if (line + 1 < detail::corpus_lines) corpus << (odd(rng) == 0 ? "\r\n" : "\n");
+	}
+
+	const std::filesystem::path filename = std::filesystem::temp_directory_path() /
+		("wordle_tests_corpus_" + std::to_string(current_process_id()) + ".txt");
+	{
+		std::ofstream out{ filename, std::ios::binary };
+		out << corpus.str();
+	}
+
+	std::vector<Word_count<detail::word_length>> expected;
+	std::istringstream in{ corpus.str() };
+	std::string line;
+	while (std::getline(in, line))
+	{
+		const size_t space = line.find_first_of(" \t");
+		std::string word = line.substr(0, space);
+		if (word.size() != detail::word_length || !std::all_of(word.begin(), word.end(), ::isalpha)) continue;
+		std::transform(word.begin(), word.end(), word.begin(), ::toupper);
+		expected.push_back({ string_t(word), size_t(std::stoull(line.substr(space + 1))) });
+	}
+
+	const std::vector<Word_count<detail::word_length>> loaded = load_word_counts(filename.string());
+	std::filesystem::remove(filename);
+
+	const bool same = loaded.size() == expected.size() && std::equal(loaded.begin(), loaded.end(), expected.begin(),
+		[](const auto& a, const auto& b) { return a.word == b.word && a.count == b.count; });
+	check(same, "load_word_counts() read " + std::to_string(loaded.size()) + " words, expected " + std::to_string(expected.size()));
+
+	check(load_word_counts("no such file.txt").empty(), "a missing file loads nothing");
+}
+
+// Tiles keep their letters and colors apart, and whole boards compare and hash by value.
+void test_packed_board()
+{
+	using Board = Packed_board<6, detail::word_length>;
+
+	Board board;
+	check(board.letters_in_row(0) == 0 && board.is_blank(0, 0) && board.letter(0, 0) == ' ', "a new board is blank");
+
+	const string_t crane = "CRANE";
+	for (size_t column = 0; column < detail::word_length; ++column)
+		board.set_letter(2, column, crane[column]);
+	check(board.is_complete(2) && board.word(2) == crane, "a typed row spells its word");
+	check(board.pattern(2) == 0, "a typed row is all grey");
+
+	board.set_color(2, 1, 2);
+	board.set_color(2, 4, 1);
+	check(board.pattern(2) == 2 * 3 + 1 * 81, "colors read back as the row's pattern");
+	check(board.letter(2, 1) == 'R' && board.letter(2, 4) == 'E', "colors leave the letters alone");
+
+	board.set_letter(2, 4, 'Z');
+	check(board.letter(2, 4) == 'Z' && board.color(2, 4) == 0, "a new letter turns its tile grey");
+
+	board.clear_tile(2, 4);
+	check(board.letters_in_row(2) == 4 && !board.is_complete(2) && board.color(2, 1) == 2, "clearing a tile leaves the others");
+
+	Board copy = board;
+	check(copy == board && copy.hash() == board.hash(), "equal boards hash the same");
+	copy.set_color(2, 0, 1);
+	check(copy != board && copy.hash() != board.hash(), "a changed color changes the board and its hash");
+
+	board.clear();
+	check(board == Board{}, "clear() blanks the whole board");
+}
+
+// Stats from games added one at a time, and from the same games split in two and merged.
+void test_stats()
+{
+	std::vector<Game_result> results;
+	for (size_t i = 0; i < 20; ++i)
+	{
+		Game_result result;
+		result.turns = 1 + i % detail::max_turns;
+		result.guesses = i % 7 == 6 ? 0 : result.turns; // every seventh game is lost
+		result.candidates_left = result.guesses == 0 ? i : 0;
+		for (size_t turn = 0; turn < result.turns; ++turn)
+		{
+			result.candidates[turn] = uint32_t(1000 >> turn);
+			result.turn_time_us[turn] = int64_t(10 * (turn + 1));
+		}
+		results.push_back(result);
+	}
+
+	Test_stats all, first_half, second_half;
+	double guess_sum = 0, guess_squares = 0;
+	size_t wins = 0;
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const std::string answer = "GAME" + std::to_string(i);
+		all.add(i, answer, results[i]);
+		(i < results.size() / 2 ? first_half : second_half).add(i, answer, results[i]);
+
+		if (!results[i].won()) continue;
+		++wins;
+		guess_sum += double(results[i].guesses);
+		guess_squares += double(results[i].guesses) * results[i].guesses;
+	}
+
+	const double mean = guess_sum / wins;
+	check(all.wins() == wins, "wins are counted");
+	check(std::abs(all.mean() - mean) < 1e-9, "the mean counts won games only");
+	check(std::abs(all.variance() - (guess_squares / wins - mean * mean)) < 1e-9, "the variance counts won games only");
+
+	size_t lost_in_order = 0;
+	for (size_t i = 0; i < all.lost_games().size(); ++i)
+		lost_in_order += all.lost_games()[i].index == 6 + 7 * i;
+	check(all.lost_games().size() == 2 && lost_in_order == 2, "lost games are kept in the order they were played");
+
+	// merging in either order gives the same report
+	Test_stats merged, reversed;
+	merged.merge(first_half);
+	merged.merge(second_half);
+	reversed.merge(second_half);
+	reversed.merge(first_half);
+
+	std::ostringstream expected, forward_json, reversed_json;
+	all.write_json(expected);
+	merged.write_json(forward_json);
+	reversed.write_json(reversed_json);
+	check(forward_json.str() == expected.str() && reversed_json.str() == expected.str(), "merged stats match stats gathered in one go");
+
+	const std::string json = expected.str();
+	check(json.find("\"games\": 20") != std::string::npos && json.find("\"lost\": 2 }") != std::string::npos,
+		"the JSON has the game count and the guess histogram");
+}
+
+// The weighted entropy score of a guess, from get_pattern() alone.
+double reference_entropy_score(const string_t& guess, const std::vector<string_t>& candidates, const std::vector<float>& priors)
+{
+	double total_weight = 0;
+	std::vector<float> weights(detail::pattern_count(detail::word_length));
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		weights[get_pattern(guess, candidates[i])] += priors[i];
+		total_weight += priors[i];
+	}
+	return weighted_entropy_score(weights, total_weight);
+}
+
+/*
+The histogram engine's scores against histograms built with get_pattern(), on both sides of the size where it
+stops skipping empty bins, and the 5-letter selectors built on the engine and kernel against the generic ones.
+Random words tie often, so a selector passes if its guess scores as well as the generic one's.
+*/
+void test_entropy()
+{
+	std::mt19937 rng{ 5 };
+	const std::vector<string_t> dictionary = random_words(detail::random_words, rng);
+	std::uniform_real_distribution<float> prior(0.0f, 1.0f);
+	Thread_pool pool{ detail::test_threads };
+
+	for (const size_t n : { size_t(1), size_t(2), size_t(3), size_t(40), detail::sparse_answers, detail::sparse_answers + 1, size_t(300) })
+	{
+		const std::vector<string_t> candidates(dictionary.begin(), dictionary.begin() + n);
+		std::vector<float> priors(n);
+		for (float& p : priors)
+			p = prior(rng);
+
+		size_t score_mismatches = 0;
+		const std::vector<Guess_score> scores = score_guesses(candidates, dictionary, pool);
+		for (size_t g = 0; g < dictionary.size(); ++g)
+		{
+			std::vector<uint32_t> histogram(detail::patterns_per_guess);
+			for (const auto& candidate : candidates)
+				++histogram[get_pattern(dictionary[g], candidate)];
+
+			score_mismatches += std::abs(scores[g].entropy - pattern_entropy(histogram, n)) > 1e-9 ||
+				scores[g].largest_bucket != *std::max_element(histogram.begin(), histogram.end()) ||
+				scores[g].is_candidate != (histogram.back() > 0);
+		}
+		check(score_mismatches == 0, std::to_string(score_mismatches) + " guesses scored wrongly against " + std::to_string(n) + " candidates");
+
+		const std::vector<float> even(n, 1.0f);
+		const double engine = reference_entropy_score(select_guess_entropy(candidates, dictionary, pool), candidates, even);
+		const double generic = reference_entropy_score(select_guess_entropy<detail::word_length>(candidates, dictionary, pool), candidates, even);
+		check(std::abs(engine - generic) < 1e-6, "the engine's guess scores as well as the generic selector's, for " + std::to_string(n) + " candidates");
+
+		const double kernel = reference_entropy_score(select_guess_entropy(candidates, priors, dictionary, pool), candidates, priors);
+		const double weighted = reference_entropy_score(select_guess_entropy<detail::word_length>(candidates, priors, dictionary, pool), candidates, priors);
+		check(std::abs(kernel - weighted) < 1e-6, "the kernel's weighted guess scores as well as the generic selector's, for " + std::to_string(n) + " candidates");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::vector<std::pair<std::string, std::function<void()>>> tests = {
+		{ "constraints", test_constraints },
+		{ "filters", test_filters },
+		{ "word_set", test_word_set },
+		{ "corpus_loader", test_corpus_loader },
+		{ "packed_board", test_packed_board },
+		{ "stats", test_stats },
+		{ "entropy", test_entropy },
+	};
+
+	const std::string selected = argc > 1 ? argv[1] : "";
+	bool found = false;
+	for (const auto& [name, run] : tests)
+	{
+		if (!selected.empty() && name != selected) continue;
+		found = true;
+		const size_t failed_before = failures;
+		run();
+		std::cout << name << ": " << (failures == failed_before ? "passed" : "FAILED") << '\n';
+	}
+
+	if (!found)
+	{
+		std::cout << "Usage: wordle_tests [test]\nTests:";
+		for (const auto& test : tests)
+			std::cout << ' ' << test.first;
+		std::cout << '\n';
+		return EXIT_FAILURE;
+	}
+
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "boost_static_string.hpp"
+
+/*
+Words, the word lists they come from, the pattern one word gets when guessed against another, and the entropy of
+a guess's patterns: what the solver, the pattern kernel and the histogram engine all build on.
+*/
+
+// Where word lists are looked for, relative to the working directory unless absolute. Builds can override it.
+#ifndef WORDLE_WORD_LIST_DIR
+#define WORDLE_WORD_LIST_DIR "../../../../Documents/word lists/"
+#endif
+
+namespace detail
+{
+	constexpr size_t word_length = 5; // the default, and the only length the GUI supports
+
+	constexpr char letter_a = 'A'; // These are here because some optimizations are case-sensitive.
+	constexpr char letter_z = 'Z';
+
+	std::string& word_list_directory()
+	{
+		static std::string directory = WORDLE_WORD_LIST_DIR;
+		return directory;
+	}
+}
+
+// Look for word lists in this directory from now on.
+void set_word_list_directory(std::string directory)
+{
+	if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+		directory += '/';
+	detail::word_list_directory() = directory;
+}
+
+template<size_t length>
+using word_t = boost::static_string<length>;
+
+using string_t = word_t<detail::word_length>;
+
+/*
+Call f with a std::integral_constant holding the runtime word length, so that each supported length runs
+its own compile-time specialization of the engine. Returns false if the length is not supported.
+*/
+template<typename F>
+bool dispatch_word_length(const size_t length, F&& f)
+{
+	switch (length)
+	{
+	case 4: f(std::integral_constant<size_t, 4>{}); return true;
+	case 5: f(std::integral_constant<size_t, 5>{}); return true;
+	case 6: f(std::integral_constant<size_t, 6>{}); return true;
+	case 7: f(std::integral_constant<size_t, 7>{}); return true;
+	default: return false;
+	}
+}
+
+template<size_t length>
+bool contains(const word_t<length>& word, const char c)
+{
+	for (size_t i = 0; i < length; ++i)
+		if (word[i] == c)
+			return true;
+	return false;
+}
+
+std::vector<string_t> load_wordle_nyt_words()
+{
+	std::fstream word_file(detail::word_list_directory() + "wordle_nyt.txt");
+
+	std::string word;
+	std::vector<string_t> word_list;
+	while (word_file >> word)
+	{
+		if (word.size() != detail::word_length) continue;
+		transform(word.begin(), word.end(), word.begin(), ::toupper);
+		word_list.push_back(string_t(word));
+	}
+
+	return word_list;
+}
+
+template<size_t length = detail::word_length>
+std::vector<word_t<length>> load_wordlist(const std::string& filename)
+{
+	std::fstream word_file(detail::word_list_directory() + filename);
+
+	std::string word;
+	std::vector<word_t<length>> word_list;
+	while (word_file >> word)
+	{
+		if (word.size() != length) continue;
+		transform(word.begin(), word.end(), word.begin(), ::toupper);
+		word_list.push_back(word_t<length>(word));
+	}
+
+	return word_list;
+}
+
+namespace detail
+{
+	constexpr size_t pattern_count(const size_t length) { return length == 0 ? 1 : 3 * pattern_count(length - 1); }
+}
+
+/*
+The feedback Wordle gives for a guess, as a base-3 number: digit i (least significant first) is 0 for a grey,
+1 for a yellow, or 2 for a green letter i. A repeated letter is only marked yellow as many times as it appears
+in the answer outside of the green positions.
+*/
+template<size_t length>
+uint32_t get_pattern(const word_t<length>& guess, const word_t<length>& answer)
+{
+	uint8_t unmatched[26]{};
+	bool green[length]{};
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		if (guess[i] == answer[i])
+			green[i] = true;
+		else
+			++unmatched[answer[i] - detail::letter_a];
+	}
+
+	uint32_t pattern = 0;
+	uint32_t place = 1;
+	for (size_t i = 0; i < length; ++i, place *= 3)
+	{
+		if (green[i])
+		{
+			pattern += 2 * place;
+		}
+		else if (unmatched[guess[i] - detail::letter_a] > 0)
+		{
+			--unmatched[guess[i] - detail::letter_a];
+			pattern += place;
+		}
+	}
+
+	return pattern;
+}
+
+// The Shannon entropy, in bits, of a histogram of patterns over n candidates. Any container of counts will do.
+template<typename Histogram>
+double pattern_entropy(const Histogram& histogram, const size_t n)
+{
+	double sum = 0;
+	for (const auto count : histogram)
+		if (count > 1)
+			sum += count * std::log2(double(count));
+
+	return std::log2(double(n)) - sum / n;
+}
+
+/*
+The entropy, in bits, of a histogram of pattern weights that sum to total_weight, plus the chance of winning
+outright: the weight of the last pattern, all green. That makes guesses that could be the answer win ties.
+*/
+template<typename Weights>
+double weighted_entropy_score(const Weights& weights, const double total_weight)
+{
+	double score = 0.0;
+	for (const auto weight : weights)
+	{
+		if (weight <= 0) continue;
+		const double q = weight / total_weight;
+		score -= q * std::log2(q);
+	}
+
+	return score + weights[weights.size() - 1] / total_weight;
+}
+
+// The best guess a thread has seen so far, by its index in the guess list. The first of equal scores wins.
+struct Best_guess
+{
+	double score = -1.0;
+	size_t index = 0;
+
+	void offer(const double guess_score, const size_t guess_index)
+	{
+		if (guess_score > score)
+			*this = { guess_score, guess_index };
+	}
+
+	// The index of the best guess of all the threads, whose ranges of the guess list are in order.
+	static size_t of(const std::vector<Best_guess>& threads)
+	{
+		return std::max_element(threads.begin(), threads.end(),
+			[](const Best_guess& a, const Best_guess& b) { return a.score < b.score; })->index;
+	}
+};
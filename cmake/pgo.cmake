@@ -0,0 +1,102 @@
+# Profile-guided optimization, from start to finish:
+#
+#   cmake [-DCOMPILER=<c++>] [-DWORDS=<dir>] [-DMARCH=<arch>] [-DBUILD_DIR=<dir>] [-DTRAINING=<benchmarks>]
+#         [-DREPEAT=<n>] -P cmake/pgo.cmake
+#
+# 1. Build and benchmark a plain Release + LTO build, as the baseline. Both benchmarks keep the fastest of REPEAT
+#    runs (3 by default) of each benchmark.
+# 2. Build with instrumentation, and run the training workload: by default, every benchmark, the sweeps of test()
+#    most of all. With GCC (-fprofile-partial-training), code the training never runs is optimized as it would be
+#    without a profile; Clang takes no such flag, so there it may be treated as cold.
+# 3. With Clang, merge the raw profiles with llvm-profdata.
+# 4. Rebuild in the same directory with the profile and LTO, and benchmark it against the baseline. The speedup
+#    of each benchmark is in <BUILD_DIR>/wordle_bench.json.
+#
+# GCC names its profiles after the object files' paths, which is why the instrumented and the optimized builds
+# share a directory. Works with GCC and Clang; the "pgo" target in CMakeLists.txt runs this with the compiler and
+# options of its own build.
+
+cmake_minimum_required(VERSION 3.16)
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+if(NOT BUILD_DIR)
+	set(BUILD_DIR "${SOURCE_DIR}/_pgo_build")
+endif()
+
+if(NOT REPEAT)
+	set(REPEAT 3)
+endif()
+
+set(PROFILE_DIR "${BUILD_DIR}/profile")
+set(BASELINE_DIR "${BUILD_DIR}/baseline")
+set(PGO_DIR "${BUILD_DIR}/pgo")
+
+set(CONFIGURE_ARGS -DCMAKE_BUILD_TYPE=Release -DWORDLE_LTO=ON "-DWORDLE_PGO_DIR=${PROFILE_DIR}")
+if(COMPILER)
+	list(APPEND CONFIGURE_ARGS "-DCMAKE_CXX_COMPILER=${COMPILER}")
+endif()
+if(DEFINED MARCH)
+	list(APPEND CONFIGURE_ARGS "-DWORDLE_MARCH=${MARCH}")
+endif()
+
+set(BENCH_ARGS)
+if(WORDS)
+	list(APPEND BENCH_ARGS --words "${WORDS}")
+endif()
+
+function(run)
+	execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		string(REPLACE ";" " " command "${ARGN}")
+		message(FATAL_ERROR "Failed (${result}): ${command}")
+	endif()
+endfunction()
+
+function(build directory pgo)
+	run(${CMAKE_COMMAND} -S "${SOURCE_DIR}" -B "${directory}" ${CONFIGURE_ARGS} "-DWORDLE_PGO=${pgo}")
+	run(${CMAKE_COMMAND} --build "${directory}" --target wordle_bench --parallel)
+endfunction()
+
+function(bench directory)
+	execute_process(COMMAND "${directory}/wordle_bench" ${BENCH_ARGS} ${ARGN} WORKING_DIRECTORY "${directory}" RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "wordle_bench failed in ${directory}")
+	endif()
+endfunction()
+
+message(STATUS "Baseline build, in ${BASELINE_DIR}")
+build("${BASELINE_DIR}" "")
+bench("${BASELINE_DIR}" --repeat ${REPEAT} --output "${BUILD_DIR}/baseline.json")
+
+message(STATUS "Instrumented build, in ${PGO_DIR}")
+file(REMOVE_RECURSE "${PROFILE_DIR}")
+file(MAKE_DIRECTORY "${PROFILE_DIR}")
+build("${PGO_DIR}" generate)
+bench("${PGO_DIR}" --output "${BUILD_DIR}/training.json" ${TRAINING})
+
+file(GLOB RAW_PROFILES "${PROFILE_DIR}/*.profraw")
+if(RAW_PROFILES)
+	# Clang: look for llvm-profdata beside the compiler first, since it must match the compiler's version.
+	set(HINTS)
+	if(COMPILER)
+		get_filename_component(COMPILER_PATH "${COMPILER}" REALPATH)
+		get_filename_component(COMPILER_DIR "${COMPILER_PATH}" DIRECTORY)
+		list(APPEND HINTS "${COMPILER_DIR}")
+	endif()
+	find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS ${HINTS})
+	if(NOT LLVM_PROFDATA)
+		message(FATAL_ERROR "Clang's raw profiles need llvm-profdata, which wasn't found")
+	endif()
+	run("${LLVM_PROFDATA}" merge "-output=${PROFILE_DIR}/wordle.profdata" ${RAW_PROFILES})
+else()
+	file(GLOB_RECURSE GCC_PROFILES "${PROFILE_DIR}/*.gcda")
+	if(NOT GCC_PROFILES)
+		message(FATAL_ERROR "The training run wrote no profiles to ${PROFILE_DIR}")
+	endif()
+endif()
+
+message(STATUS "Optimized build, in ${PGO_DIR}")
+build("${PGO_DIR}" use)
+bench("${PGO_DIR}" --repeat ${REPEAT} --output "${BUILD_DIR}/wordle_bench.json" --baseline "${BUILD_DIR}/baseline.json")
+
+message(STATUS "Speedups over the baseline are in ${BUILD_DIR}/wordle_bench.json")